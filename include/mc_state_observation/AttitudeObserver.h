@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mc_observers/Observer.h>
+#include <mc_state_observation/observersTools/timingTools.h>
 
 #include <state-observation/dynamical-system/imu-dynamical-system.hpp>
 #include <state-observation/observer/extended-kalman-filter.hpp>
@@ -68,6 +69,9 @@ protected:
   std::string imuSensor_ = ""; ///< Name of the sensor used for IMU readings
   std::string updateSensor_ = ""; ///< Name of the sensor to update with the results (default: imuSensor_)
   std::string datastoreName_ = ""; ///< Name on the datastore (default name())
+  std::string accRefKey_ = ""; ///< Datastore key of the reference acceleration (datastoreName_ + "::accRef")
+  size_t imuSensorIndex_ = 0; ///< Index of imuSensor_ in the body sensors of the robot
+  size_t updateSensorIndex_ = 0; ///< Index of updateSensor_ in the body sensors of the robot
   KalmanFilterConfig defaultConfig_; ///< Default configuration for the KF (as set by configure())
   KalmanFilterConfig config_; ///< Current configuration for the KF (GUI, etc...)
   bool log_kf_ = false; ///< Whether to log the parameters of the kalman filter
@@ -87,6 +91,9 @@ protected:
   /// initalization of the functor
   stateObservation::IMUDynamicalSystem imuFunctor_;
 
+  /// derivation step of the finite differences
+  stateObservation::Vector dx_;
+
   stateObservation::Matrix q_;
   stateObservation::Matrix r_;
 
@@ -97,6 +104,12 @@ protected:
   stateObservation::Matrix3 Kpo_, Kdo_;
 
   Eigen::Matrix3d m_orientation = Eigen::Matrix3d::Identity(); ///< Result
+
+  /// @{
+  timingTools::ExecutionTimer timer_; ///< Measures the computation time of the observer
+  size_t runTiming_ = 0; ///< Index of the run() stage in timer_
+  size_t updateTiming_ = 0; ///< Index of the update() stage in timer_
+  /// @}
 };
 
 } // namespace mc_state_observation
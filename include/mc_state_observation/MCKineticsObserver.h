@@ -4,8 +4,13 @@
 
 #include <mc_rbdyn/Contact.h>
 #include <mc_rbdyn/Robot.h>
+#include <mc_rtc/DataStore.h>
 #include <boost/circular_buffer.hpp>
+#include <mc_state_observation/gui_helpers.h>
+#include <mc_state_observation/observersTools/captureTools.h>
 #include <mc_state_observation/observersTools/measurementsTools.h>
+#include <mc_state_observation/observersTools/threadingTools.h>
+#include <mc_state_observation/observersTools/timingTools.h>
 #include <state-observation/dynamics-estimators/kinetics-observer.hpp>
 
 #include <mc_observers/Observer.h>
@@ -65,9 +70,19 @@ public:
 
 struct MCKineticsObserver : public mc_observers::Observer
 {
+  /// @brief Measurement of the pose of the floating base in the world given by an external source (mocap, SLAM, ...).
+  struct AbsolutePoseMeasurement
+  {
+    sva::PTransformd X_0_fb = sva::PTransformd::Identity(); // measured pose of the floating base in the world
+    double time = 0.0; // time of the measurement, in the time of the controller's logger
+    bool withPosition = true; // if false, only the orientation is measured
+  };
 
   MCKineticsObserver(const std::string & type, double dt);
 
+  /// @brief Removes the entries of the datastore that call this observer.
+  ~MCKineticsObserver() override;
+
   void configure(const mc_control::MCController & ctl, const mc_rtc::Configuration &) override;
 
   void reset(const mc_control::MCController & ctl) override;
@@ -227,6 +242,11 @@ protected:
                                    KoContactWithSensor & contact,
                                    stateObservation::kine::Kinematics & worldContactKineRef);
 
+  /// @brief Checks if the force sensor of the contact is used in the correction of the Kinetics Observer.
+  /// @details The sensor must be enabled, and it is ignored in the degraded mode if the contact is degradable.
+  /// @param contact The contact to check.
+  bool useContactSensor(const KoContactWithSensor & contact) const;
+
   /// @brief Update the contact or create it if it still does not exist.
   /// @details Called by \ref updateContacts(const mc_control::MCController & ctl, std::set<std::string> contacts,
   /// mc_rtc::Logger & logger).
@@ -265,6 +285,24 @@ public:
    */
   void updateNoiseCovariance();
 
+  /// @brief Gives a new measurement of the absolute pose of the floating base.
+  /// @details This function is the only one of the observer that can be called outside of the control thread, from
+  /// one thread at a time. The measurement is only used in the next iteration, as a correction of the Kinetics
+  /// Observer, and the iterations without new measurement are not modified. Also available from the datastore as
+  /// "<observer name>::setAbsolutePose", which like the rest of the datastore must only be used on the control thread.
+  /// @param X_0_fb Measured pose of the floating base in the world.
+  /// @param time Time of the measurement, in the time of the controller's logger. The measurements older than
+  /// absolutePoseMaxDelay are ignored.
+  /// @param withPosition If false, only the orientation is measured.
+  inline void setAbsolutePose(const sva::PTransformd & X_0_fb, double time, bool withPosition = true)
+  {
+    auto & measurement = absolutePoseInput_.back();
+    measurement.X_0_fb = X_0_fb;
+    measurement.time = time;
+    measurement.withPosition = withPosition;
+    absolutePoseInput_.publish();
+  }
+
   /** Get accelerometer measurement noise covariance.
    *
    */
@@ -353,8 +391,10 @@ private:
   std::string observerName_ = "MCKineticsObserver";
   // name of the robot
   std::string robot_ = "";
-  /* custom list of robots to display */
+  /* custom list of robots */
   std::shared_ptr<mc_rbdyn::Robots> my_robots_;
+  // estimated robot displayed in the GUI
+  gui::DisplayRobot displayRobot_;
   // std::string imuSensor_ = "";
   mc_rbdyn::BodySensorVector IMUs_; ///< list of IMUs
 
@@ -492,6 +532,36 @@ private:
   // Buffer containing the estimated pose of the floating base in the world over the whole backup interval.
   boost::circular_buffer<stateObservation::kine::Kinematics> koBackupFbKinematics_;
 
+  /* Capture of the inputs */
+  // records the inputs of every iteration or replays them from a previous capture
+  captureTools::InputsCapture inputsCapture_;
+
+  /* Computation time measurements */
+  timingTools::ExecutionTimer timer_;
+  size_t runTiming_ = 0; // index of the run() stage in timer_
+  size_t contactsTiming_ = 0; // index of the contacts update stage in timer_
+  size_t imusTiming_ = 0; // index of the IMUs update stage in timer_
+  size_t estimatorTiming_ = 0; // index of the Kinetics Observer's update stage in timer_
+  size_t updateTiming_ = 0; // index of the update() stage in timer_
+
+  /* Degradation under load */
+  // switches to the degraded mode when the iterations exceed their time budget
+  timingTools::DeadlineMonitor deadline_;
+  // contacts whose force sensor is not used in the correction in the degraded mode. All the contacts if empty.
+  std::set<std::string> degradableContacts_;
+
+  /* Absolute pose measurements */
+  // datastore holding the "<observer name>::setAbsolutePose" call, removed when the observer is destroyed
+  mc_rtc::DataStore * datastore_ = nullptr;
+  // measurements given by setAbsolutePose()
+  threadingTools::LatestValueSlot<AbsolutePoseMeasurement> absolutePoseInput_;
+  // last measurement given to the Kinetics Observer
+  AbsolutePoseMeasurement absolutePose_;
+  // delay between the measurement and its use (s)
+  double absolutePoseDelay_ = 0.0;
+  // the measurements older than this delay (s) are ignored
+  double absolutePoseMaxDelay_ = 0.1;
+
   /* Debug variables */
   // For logs only. Prediction of the measurements from the newly corrected state
   stateObservation::Vector correctedMeasurements_;
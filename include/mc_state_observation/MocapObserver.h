@@ -3,10 +3,16 @@
 #include <mc_control/MCController.h>
 #include <mc_observers/Observer.h>
 #include <mc_rbdyn/Robot.h>
+#include <mc_state_observation/observersTools/timingTools.h>
 
 namespace mc_state_observation
 {
 
+/** Estimates the pose of the floating base of robots from the poses of markers measured by a motion capture system.
+ * One observer can track several bodies (possibly of different robots), whose markers come from the same motion capture
+ * system: they share the transformation between the world and the mocap origin, and they are all updated in the same
+ * iteration of the observer. The markers poses are given by the front-ends (MocapObserverROS, MocapObserverUDP).
+ **/
 struct MocapObserver : public mc_observers::Observer
 {
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
@@ -21,24 +27,32 @@ struct MocapObserver : public mc_observers::Observer
 
   void update(mc_control::MCController & ctl) override;
 
-  /** Set the marker frame pose, expressed in mocap origin frame */
-  void markerPose(const sva::PTransformd & pose)
+  /** Set the marker frame pose of the tracked body of index i, expressed in mocap origin frame */
+  void markerPose(size_t i, const sva::PTransformd & pose)
   {
-    X_m_marker_ = pose;
-    gotMarker_ = true;
+    bodies_[i].X_m_marker = pose;
+    bodies_[i].gotMarker = true;
   }
 
-  /** Pose of the mocap marker frame expressed in the mocap origin frame */
-  const sva::PTransformd & markerPose() const noexcept { return X_m_marker_; }
+  /** Set the marker frame pose of the first tracked body, expressed in mocap origin frame */
+  void markerPose(const sva::PTransformd & pose) { markerPose(0, pose); }
 
-  mc_rbdyn::Robot & robot(mc_control::MCController & ctl)
+  /** Pose of the mocap marker frame of the tracked body of index i expressed in the mocap origin frame */
+  const sva::PTransformd & markerPose(size_t i = 0) const noexcept { return bodies_[i].X_m_marker; }
+
+  /** Number of bodies tracked by the observer */
+  size_t nbTrackedBodies() const noexcept { return bodies_.size(); }
+
+  mc_rbdyn::Robot & robot(mc_control::MCController & ctl, size_t i = 0)
   {
-    return useReal_ ? ctl.realRobot(robot_) : ctl.robot(robot_);
+    const auto & tracked = bodies_[i];
+    return tracked.useReal ? ctl.realRobot(tracked.robot) : ctl.robot(tracked.robot);
   }
 
-  const mc_rbdyn::Robot & robot(const mc_control::MCController & ctl) const
+  const mc_rbdyn::Robot & robot(const mc_control::MCController & ctl, size_t i = 0) const
   {
-    return useReal_ ? ctl.realRobot(robot_) : ctl.robot(robot_);
+    const auto & tracked = bodies_[i];
+    return tracked.useReal ? ctl.realRobot(tracked.robot) : ctl.robot(tracked.robot);
   }
 
 protected:
@@ -62,31 +76,106 @@ protected:
                 const std::vector<std::string> & /* category */) override;
 
   bool checkPipelines(const mc_control::MCController &);
+  /// @brief Calibrates the marker to body transformations, from a single sample or by starting the accumulation of
+  /// samples (see calibrationSamples_).
+  /// @return True if the calibration is done.
   bool calibrateMarkerToBody(const mc_control::MCController &);
+  /// @brief Initializes the mocap origin, from a single sample or by starting the accumulation of samples (see
+  /// calibrationSamples_).
+  /// @return True if the origin is initialized.
   bool initializeOrigin(const mc_control::MCController &);
 
+  /// @brief Sample of the marker to body transformation of the tracked body of index i.
+  sva::PTransformd markerToBodySample(const mc_control::MCController & ctl, size_t i) const;
+  /// @brief Sample of the world to mocap origin transformation, obtained from the first tracked body.
+  sva::PTransformd originSample(const mc_control::MCController & ctl) const;
+  /// @brief Adds the samples of the current iteration to the calibration in progress and finalizes it once enough
+  /// samples with a low variance are accumulated.
+  void accumulateCalibration(const mc_control::MCController & ctl);
+
 protected:
-  /// @{
-  std::string robot_ = ""; ///< Name of robot to which the MOCAP marker is attached
-  bool useReal_ = false;
-  std::string updateRobot_ = ""; ///< Name of the robot to update
-  std::string body_ = ""; ///< Body to which the marker is attached
-  /// @}
+  /// @brief Running mean and covariance of a set of poses, computed with O(1) memory.
+  /// @details The mean and covariance of the translation use Welford's algorithm. The mean orientation is moved by a
+  /// geodesic step of 1/n towards each new sample, and the covariance of the orientation is the one of the rotation
+  /// vectors of the samples relatively to the mean.
+  struct PoseAccumulator
+  {
+    void reset() { nbSamples = 0; }
+    void add(const sva::PTransformd & pose);
+    sva::PTransformd mean() const;
+    /// Square root of the trace of the covariance of the translation [m]
+    double translationStd() const;
+    /// Square root of the trace of the covariance of the rotation vector [rad]
+    double orientationStd() const;
+
+    size_t nbSamples = 0;
+    Eigen::Vector3d meanTranslation = Eigen::Vector3d::Zero();
+    Eigen::Quaterniond meanOrientation = Eigen::Quaterniond::Identity();
+    Eigen::Matrix3d translationM2 = Eigen::Matrix3d::Zero(); ///< Sum of the squared deviations of the translation
+    Eigen::Matrix3d orientationM2 = Eigen::Matrix3d::Zero(); ///< Sum of the squared deviations of the orientation
+  };
+
+  enum class CalibrationTarget
+  {
+    none,
+    markers, ///< marker to body transformations of all the tracked bodies
+    origin ///< world to mocap origin transformation
+  };
+
+  /// @brief Body tracked with a marker of the motion capture.
+  struct TrackedBody
+  {
+    std::string name; ///< Name of the tracked body in the logs and the GUI (empty for a single tracked body)
+    std::string robot; ///< Name of robot to which the MOCAP marker is attached
+    bool useReal = false;
+    std::string updateRobot; ///< Name of the robot to update
+    bool update = true; ///< Whether the floating base of updateRobot is updated from this body
+    std::string body; ///< Body to which the marker is attached
+
+    sva::PTransformd X_marker_body =
+        sva::PTransformd::Identity(); ///< Extrinsic calibration from body to marker frame (auto-determined)
+
+    sva::PTransformd X_m_marker = sva::PTransformd::Identity(); ///< Measured pose of the marker in the mocap frame
+    bool gotMarker = false;
+    sva::PTransformd X_0_marker = sva::PTransformd::Identity(); ///< Estimated pose of the marker frame
+    sva::PTransformd X_0_fb = sva::PTransformd::Identity(); ///< Estimated pose of the floating base
+
+    std::vector<int> fbToBodyChain; ///< Bodies from the floating base (excluded) to the marker's body (included)
+    bool rigidBodyToFb = true; ///< True if no actuated joint lies between the floating base and the marker's body
+    sva::PTransformd X_fb_body = sva::PTransformd::Identity(); ///< Pose of the marker's body in the floating base frame
+
+    PoseAccumulator calibrationSamples; ///< Samples of the calibration in progress
+  };
+
+  /// @brief Reads the configuration of a tracked body.
+  TrackedBody configureBody(const mc_control::MCController & ctl, const mc_rtc::Configuration & config) const;
+
+  /// @brief Prefix of the log entries of the tracked body of index i.
+  std::string logPrefix(const std::string & category, size_t i) const;
+
+protected:
+  std::vector<TrackedBody> bodies_; ///< Tracked bodies, in the order of the configuration
 
   /// @{
   bool calibrated_ = false;
-  sva::PTransformd X_marker_body_ =
-      sva::PTransformd::Identity(); ///< Extrinsic calibration from body to marker frame (auto-determined)
   bool originInitialized_ = false;
   sva::PTransformd X_0_mocap_ =
       sva::PTransformd::Identity(); ///< Transformation from robot world to mocap world (auto-determined)
   /// @}
 
-  // {@
-  sva::PTransformd X_m_marker_ = sva::PTransformd::Identity();
-  bool gotMarker_ = false;
-  sva::PTransformd X_0_marker_ = sva::PTransformd::Identity(); // Estimated pose of the marker frame
-  sva::PTransformd X_0_fb_ = sva::PTransformd::Identity(); // Estimated pose of the floating base
-  // @}
+  /// @{
+  CalibrationTarget calibrationTarget_ = CalibrationTarget::none; ///< Calibration in progress
+  size_t calibrationSamples_ = 1; ///< Number of samples of a calibration (1: single snapshot)
+  double calibrationMaxTranslationStd_ = 0.002; ///< Maximum translation deviation of the samples [m]
+  double calibrationMaxOrientationStd_ = 0.01; ///< Maximum orientation deviation of the samples [rad]
+  size_t calibrationMaxAttempts_ = 10; ///< Number of sets of samples before the calibration is aborted
+  size_t calibrationAttempt_ = 0; ///< Index of the current set of samples
+  /// @}
+
+  /// @{
+  timingTools::ExecutionTimer timer_; ///< Measures the computation time of the observer
+  size_t runTiming_ = 0; ///< Index of the run() stage in timer_
+  size_t updateTiming_ = 0; ///< Index of the update() stage in timer_
+  /// @}
 };
 } // namespace mc_state_observation
@@ -18,8 +18,9 @@ struct MocapObserverROS : public MocapObserver
   bool run(const mc_control::MCController & ctl) override;
 
 protected:
-  std::string marker_ = "mocap/base_link"; ///< Name of the marker
+  std::vector<std::string> markers_; ///< Name of the marker of each tracked body
   std::string markerOrigin_ = "mocap"; ///< Name of the origin frame for the marker
+  size_t lookupTiming_ = 0; ///< Index of the tf lookup stage in timer_
 
   mc_rtc::NodeHandlePtr nh_ = nullptr;
   tf2_ros::Buffer tfBuffer_;
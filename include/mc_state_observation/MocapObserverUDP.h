@@ -0,0 +1,75 @@
+#pragma once
+
+#include <mc_state_observation/MocapObserver.h>
+#include <mc_state_observation/MocapUDPPacket.h>
+#include <mc_state_observation/observersTools/threadingTools.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace mc_state_observation
+{
+
+/**
+ * Front-end of the MocapObserver receiving the marker poses as MocapUDPPacket datagrams on a local UDP socket, without
+ * ROS. Each datagram contains the poses of the markers of all the tracked bodies. The datagrams are decoded on a
+ * dedicated thread and the latest frame is handed to the control thread through a lock-free slot.
+ **/
+struct MocapObserverUDP : public MocapObserver
+{
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  MocapObserverUDP(const std::string & type, double dt);
+
+  ~MocapObserverUDP() override;
+
+  void configure(const mc_control::MCController & ctl, const mc_rtc::Configuration &) override;
+
+  void reset(const mc_control::MCController & ctl) override;
+
+  bool run(const mc_control::MCController & ctl) override;
+
+protected:
+  void addToLogger(const mc_control::MCController &, mc_rtc::Logger &, const std::string & category) override;
+
+  void removeFromLogger(mc_rtc::Logger &, const std::string & category) override;
+
+  /// @brief Receives and decodes the datagrams until stopReception() is called.
+  void receiveLoop();
+
+  /// @brief Stops and joins the receive thread and closes the socket.
+  void stopReception();
+
+protected:
+  /// Poses of the markers of the tracked bodies decoded by the receive thread from one datagram
+  struct MarkersFrame
+  {
+    std::array<sva::PTransformd, mocapUDPMaxMarkers> poses; ///< Pose of the marker of each tracked body
+    uint64_t received = 0; ///< Bit i is set if the pose of the tracked body i is in the frame
+    uint32_t sequence = 0;
+    std::chrono::steady_clock::time_point receptionTime;
+  };
+
+  /// @{
+  std::string address_ = "127.0.0.1"; ///< Address on which the datagrams are received
+  int port_ = 9870; ///< Port on which the datagrams are received
+  double timeout_ = 0.1; ///< Maximum age of the last received pose [s] before the estimation fails
+  std::vector<uint32_t> markerIds_; ///< Identifier of the marker of each tracked body
+  /// @}
+
+  int socket_ = -1;
+  std::thread receiveThread_;
+  std::atomic<bool> stop_{false};
+  threadingTools::LatestValueSlot<MarkersFrame> markersSlot_;
+  std::atomic<uint64_t> invalidPackets_{0}; ///< Number of received datagrams that are not a MocapUDPPacket
+
+  /// @{
+  uint32_t sequence_ = 0; ///< Sequence number of the last used frame
+  double latency_ = 0.0; ///< Time between the reception of the last used frame and its use [ms]
+  std::vector<std::chrono::steady_clock::time_point> receptionTimes_; ///< Last reception of each marker
+  /// @}
+};
+
+} // namespace mc_state_observation
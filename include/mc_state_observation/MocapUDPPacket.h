@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mc_state_observation
+{
+
+/// Maximum number of markers in a MocapUDPPacket
+constexpr size_t mocapUDPMaxMarkers = 32;
+
+/// Pose of a marker measured by the motion capture
+struct MocapUDPMarker
+{
+  uint32_t id; // identifier of the marker, associated to a tracked body in the configuration of the observer
+  uint32_t reserved;
+  double translation[3]; // position of the marker in the mocap origin frame
+  double rotation[4]; // orientation of the marker in the mocap origin frame, as a unit quaternion (w, x, y, z)
+};
+
+/**
+ * Datagram sent to the MocapObserverUDP for each frame of the motion capture, containing the poses of all the markers
+ * measured in this frame. Only the first nbMarkers markers are sent, the size of the datagram is therefore
+ * mocapUDPPacketSize(nbMarkers). All the fields are in the native byte order of the machine, as the sender is expected
+ * to run on the same machine or on the local network of the robot.
+ **/
+struct MocapUDPPacket
+{
+  char magic[4]; // "MCSM"
+  uint32_t sequence; // index of the frame, incremented by the sender
+  uint32_t nbMarkers; // number of markers in the frame
+  uint32_t reserved;
+  MocapUDPMarker markers[mocapUDPMaxMarkers];
+};
+
+constexpr char mocapUDPMagic[4] = {'M', 'C', 'S', 'M'};
+
+/// Size of a datagram containing the given number of markers
+constexpr size_t mocapUDPPacketSize(size_t nbMarkers)
+{
+  return offsetof(MocapUDPPacket, markers) + nbMarkers * sizeof(MocapUDPMarker);
+}
+
+} // namespace mc_state_observation
@@ -5,7 +5,9 @@
 #include <mc_rbdyn/Contact.h>
 #include <mc_rbdyn/Robot.h>
 
+#include <mc_state_observation/gui_helpers.h>
 #include <mc_state_observation/observersTools/leggedOdometryTools.h>
+#include <mc_state_observation/observersTools/timingTools.h>
 #include <state-observation/dynamics-estimators/kinetics-observer.hpp>
 
 #include <mc_observers/Observer.h>
@@ -111,8 +113,8 @@ public:
 
 private:
   std::string category_ = "NaiveOdometry_";
-  /* custom list of robots to display */
-  std::shared_ptr<mc_rbdyn::Robots> my_robots_;
+  // estimated robot displayed in the GUI
+  gui::DisplayRobot displayRobot_;
 
   // threshold on the force for the contact detection.
   double contactDetectionThreshold_;
@@ -129,6 +131,12 @@ private:
 
   bool accUpdatedUpstream_ = false;
 
+  /// @{
+  timingTools::ExecutionTimer timer_; ///< Measures the computation time of the observer
+  size_t runTiming_ = 0; ///< Index of the run() stage in timer_
+  size_t updateTiming_ = 0; ///< Index of the update() stage in timer_
+  /// @}
+
   using LoContactsManager = leggedOdometry::LeggedOdometryManager::ContactsManager;
 };
 
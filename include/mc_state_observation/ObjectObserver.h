@@ -1,10 +1,13 @@
 #pragma once
 
 #include <mc_state_observation/filtering.h>
+#include <mc_state_observation/observersTools/threadingTools.h>
+#include <mc_state_observation/observersTools/timingTools.h>
 #include <mc_state_observation/ros.h>
 
 #include <mc_observers/Observer.h>
 
+#include <atomic>
 #include <mutex>
 #include <thread>
 
@@ -17,6 +20,8 @@ struct ObjectObserver : public mc_observers::Observer
 
   ObjectObserver(const std::string & type, double dt);
 
+  ~ObjectObserver() override;
+
   void configure(const mc_control::MCController & ctl, const mc_rtc::Configuration &) override;
 
   void reset(const mc_control::MCController & ctl) override;
@@ -75,10 +80,19 @@ protected:
 
   mc_rtc::NodeHandlePtr nh_ = nullptr;
   void rosSpinner();
+  /// @brief Stops and joins the ROS thread.
+  void stopSpinner();
   std::thread thread_;
+  std::atomic<bool> stopSpinner_{false}; ///< Requests the ROS thread to stop
 
   bool isEstimatedPoseValid_ = false;
 
   bool isNotFirstTimeInCallback_ = false;
+
+  /// @{
+  timingTools::ExecutionTimer timer_; ///< Measures the computation time of the observer
+  size_t runTiming_ = 0; ///< Index of the run() stage in timer_
+  size_t updateTiming_ = 0; ///< Index of the update() stage in timer_
+  /// @}
 };
 } // namespace mc_state_observation
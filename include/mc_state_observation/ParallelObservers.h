@@ -0,0 +1,92 @@
+#pragma once
+
+#include <mc_observers/Observer.h>
+#include <mc_state_observation/observersTools/threadingTools.h>
+#include <mc_state_observation/observersTools/timingTools.h>
+
+#include <exception>
+#include <memory>
+
+namespace mc_state_observation
+{
+
+/** Runs a group of observers whose estimations are independent from each other within one iteration on a pool of
+ * worker threads.
+ * Each child observer can declare the observers it depends on. The observers are sorted by dependency level: the
+ * observers of a level that are declared parallel-safe are run concurrently, then the other observers of the level are
+ * run one after the other on the calling thread, and finally the observers of the level that require it update the
+ * robots (in the order of the configuration, on the calling thread), before the next level is run. The latency of the
+ * group is therefore the one of its critical path instead of the sum of the computation times of its observers.
+ *
+ * An observer can be declared parallel-safe only if its run() function does not write to shared data (for example by
+ * adding or removing log entries or GUI elements, by modifying the datastore or the robots of the controller), as
+ * neither mc_rtc::Logger nor the robots are thread-safe.
+ **/
+struct ParallelObservers : public mc_observers::Observer
+{
+  ParallelObservers(const std::string & type, double dt);
+
+  void configure(const mc_control::MCController & ctl, const mc_rtc::Configuration &) override;
+
+  void reset(const mc_control::MCController & ctl) override;
+
+  bool run(const mc_control::MCController & ctl) override;
+
+  void update(mc_control::MCController & ctl) override;
+
+protected:
+  /*! \brief Add observer from logger
+   *
+   * @param category Category in which to log this observer
+   */
+  void addToLogger(const mc_control::MCController &, mc_rtc::Logger &, const std::string & category) override;
+
+  /*! \brief Remove observer from logger
+   *
+   * @param category Category in which this observer entries are logged
+   */
+  void removeFromLogger(mc_rtc::Logger &, const std::string & category) override;
+
+  /*! \brief Add observer information the GUI.
+   *
+   * @param category Category in which to add this observer
+   */
+  void addToGUI(const mc_control::MCController &,
+                mc_rtc::gui::StateBuilder &,
+                const std::vector<std::string> & /* category */) override;
+
+protected:
+  /// @brief Child observer and its scheduling information.
+  struct ChildObserver
+  {
+    mc_observers::ObserverPtr observer;
+    bool update = false; ///< Whether the child updates the robots after its run
+    bool parallelSafe = false; ///< Whether the child can be run concurrently with the other observers of its level
+    size_t level = 0; ///< Dependency level: 1 + the maximum level of the observers it depends on
+    bool success = true; ///< Result of the last run
+    std::exception_ptr exception; ///< Exception thrown by the last run, rethrown on the control thread
+  };
+
+  /// @{
+  std::vector<ChildObserver> observers_; ///< Child observers, in the order of the configuration
+  std::vector<std::vector<size_t>> levels_; ///< Indexes of the child observers of each dependency level
+  std::vector<std::vector<size_t>> concurrentLevels_; ///< Indexes of the parallel-safe child observers of each level
+  std::unique_ptr<threadingTools::WorkerPool> pool_; ///< Workers running the child observers
+  /// @}
+
+  /// @brief Runs the child observer, storing the exception it may throw to rethrow it on the control thread.
+  void runChild(ChildObserver & child);
+
+  /// @{
+  const mc_control::MCController * ctl_ = nullptr; ///< Controller given to the current run
+  const std::vector<size_t> * currentLevel_ = nullptr; ///< Parallel-safe observers run by the workers
+  std::function<void(size_t)> runTask_; ///< Task running the i-th observer of the current level
+  /// @}
+
+  /// @{
+  timingTools::ExecutionTimer timer_; ///< Measures the computation time of the observer
+  size_t runTiming_ = 0; ///< Index of the run() stage in timer_
+  /// @}
+};
+
+} // namespace mc_state_observation
@@ -1,13 +1,16 @@
 #pragma once
 
 #include <mc_state_observation/filtering.h>
+#include <mc_state_observation/observersTools/threadingTools.h>
+#include <mc_state_observation/observersTools/timingTools.h>
 #include <mc_state_observation/ros.h>
 
 #include <mc_observers/Observer.h>
 
-#include <tf2_ros/transform_broadcaster.h>
+#include <tf2_ros/static_transform_broadcaster.h>
 #include <tf2_ros/transform_listener.h>
 
+#include <atomic>
 #include <thread>
 
 namespace mc_state_observation
@@ -19,6 +22,8 @@ struct SLAMObserver : public mc_observers::Observer
 
   SLAMObserver(const std::string & type, double dt);
 
+  ~SLAMObserver() override;
+
   void configure(const mc_control::MCController & ctl, const mc_rtc::Configuration &) override;
 
   void reset(const mc_control::MCController & ctl) override;
@@ -57,6 +62,25 @@ protected:
   /** Toggle plots on/off */
   void togglePlots(mc_rtc::gui::StateBuilder & gui);
 
+  /// @brief Camera pose estimated by the SLAM and its filtered counterpart, passed from the ROS thread to the control
+  /// thread.
+  struct CameraPose
+  {
+    sva::PTransformd X_0_camera = sva::PTransformd::Identity(); ///< Pose of the camera in robot_map
+    sva::PTransformd X_0_filtered_camera = sva::PTransformd::Identity(); ///< Filtered pose, valid if filtered
+    bool filtered = false; ///< True if the filter was ready when the pose was received
+    double filterDuration = 0.0; ///< Computation time of the filter (ms)
+  };
+
+  /// @brief Retrieves the camera pose if a new one was received since the last call. Called by the ROS thread.
+  /// @param X_0_Camera Received pose of the camera in robot_map.
+  /// @param lastStamp Stamp of the last received pose, updated on reception.
+  /// @return True if a new pose was received.
+  bool receiveCameraPose(sva::PTransformd & X_0_Camera, decltype(TransformStamped::header.stamp) & lastStamp);
+
+  /// @brief Filters the received camera pose and publishes it to the control thread. Called by the ROS thread.
+  void filterCameraPose(const sva::PTransformd & X_0_Camera);
+
 protected:
   /// @{
   std::string robot_ = ""; ///< Name of robot to estimate thanks to SLAM
@@ -72,6 +96,7 @@ protected:
   sva::PTransformd X_Slam_Estimated_Camera_ =
       sva::PTransformd::Identity(); ///< Transformation to go from SLAM world to estimated camera
   sva::PTransformd X_0_Slam_ = sva::PTransformd::Identity(); ///< Transformation to go from Robot world to SLAM world
+  bool X_0_Slam_changed_ = true; ///< X_0_Slam_ changed since it was last broadcast
   sva::PTransformd X_0_Estimated_camera_ =
       sva::PTransformd::Identity(); ///< Camera pose in Robot world estimated by SLAM
   bool isSLAMAlive_ = false; ///< Check if slam is alive or not
@@ -84,18 +109,32 @@ protected:
 
   mc_rtc::NodeHandlePtr nh_ = nullptr;
   void rosSpinner();
+  /// @brief Stops and joins the ROS thread.
+  void stopSpinner();
   std::thread thread_;
+  std::atomic<bool> stopSpinner_{false}; ///< Requests the ROS thread to stop
   tf2_ros::Buffer tfBuffer_;
   tf2_ros::TransformListener tfListener_{tfBuffer_};
-  tf2_ros::TransformBroadcaster tfBroadcaster_;
+  tf2_ros::StaticTransformBroadcaster tfStaticBroadcaster_; ///< Broadcasts the latched robot_map -> map transform
 
   /// @{
-  bool isFiltered_ = false; ///< Check if a filter is apply or not
-  std::unique_ptr<filter::Transform> filter_; ///< Filter based on savitzky-golay
+  std::atomic<bool> isFiltered_{false}; ///< Check if a filter is apply or not
+  std::unique_ptr<filter::Transform> filter_; ///< Filter based on savitzky-golay, only used by the ROS thread
+  Eigen::Vector3d filterParams_ = Eigen::Vector3d(150, 0, 5); ///< Parameters (m, d, n) of the filter
+  threadingTools::LatestValueSlot<Eigen::Vector3d> newFilterParams_; ///< Filter parameters set from the GUI
+  std::atomic<bool> resetFilter_{false}; ///< Requests the ROS thread to reset the filter
+  bool isFilterReady_ = false; ///< The last received pose was filtered
   sva::PTransformd X_0_Filtered_estimated_camera_ =
       sva::PTransformd::Identity(); ///< Estimated camera pose in robot_map
   /// @}
 
+  /// @{
+  threadingTools::LatestValueSlot<CameraPose> cameraPoses_; ///< Filtered poses sent by the ROS thread
+  threadingTools::LatestValueSlot<sva::PTransformd> simulatedCameraPoses_; ///< Simulated poses sent to the ROS thread
+  bool hasCameraPose_ = false; ///< A camera pose was received since the initialization
+  double filterDuration_ = 0.0; ///< Computation time of the filter for the last received pose (ms)
+  /// @}
+
   /// @{
   bool isPublished_ = true; ///< Check if estimated robot is publish or not
   /// @}
@@ -113,6 +152,12 @@ protected:
   bool plotsEnabled_ = false; ///< Are GUI plots enabled
   /// @}
 
+  /// @{
+  timingTools::ExecutionTimer timer_; ///< Measures the computation time of the observer
+  size_t runTiming_ = 0; ///< Index of the run() stage in timer_
+  size_t updateTiming_ = 0; ///< Index of the update() stage in timer_
+  /// @}
+
   double t_ = 0.0;
 };
 } // namespace mc_state_observation
@@ -2,7 +2,11 @@
 
 #include <mc_observers/Observer.h>
 #include <boost/circular_buffer.hpp>
+#include <mc_state_observation/gui_helpers.h>
+#include <mc_state_observation/observersTools/captureTools.h>
+#include <mc_state_observation/observersTools/kinematicsTools.h>
 #include <mc_state_observation/observersTools/leggedOdometryTools.h>
+#include <mc_state_observation/observersTools/timingTools.h>
 #include <state-observation/observer/tilt-estimator-humanoid.hpp>
 #include <state-observation/tools/rigid-body-kinematics.hpp>
 
@@ -105,6 +109,8 @@ protected:
 
   // container for our robots
   std::shared_ptr<mc_rbdyn::Robots> my_robots_;
+  // estimated robot displayed in the GUI
+  gui::DisplayRobot displayRobot_;
 
   std::string robot_; // name of the robot
   bool updateRobot_ = true; // indicates whether we use our estimation to update the real robot or not
@@ -209,6 +215,19 @@ protected:
   bool asBackup_ = false; // indicates if the estimator is used as a backup or not
   // Buffer containing the estimated pose of the floating base in the world over the whole backup interval.
   boost::circular_buffer<sva::PTransformd> backupFbKinematics_ = boost::circular_buffer<sva::PTransformd>(100);
+  // poses of the backup interval, and the same poses transferred to the new initial pose of the Kinetics Observer
+  kinematicsTools::PoseArray backupPoses_;
+  kinematicsTools::PoseArray transferredBackupPoses_;
+
+  /* Capture of the inputs */
+  // records the inputs of every iteration or replays them from a previous capture
+  captureTools::InputsCapture inputsCapture_;
+
+  /* Computation time measurements */
+  timingTools::ExecutionTimer timer_;
+  size_t runTiming_ = 0; // index of the run() stage in timer_
+  size_t estimatorTiming_ = 0; // index of the runTiltEstimator() stage in timer_
+  size_t updateTiming_ = 0; // index of the update() stage in timer_
 
   /* Debug variables */
   // "measured" local linear velocity of the IMU
@@ -1,8 +1,14 @@
+#pragma once
+
+#include <mc_rbdyn/Robots.h>
 #include <mc_rbdyn/rpy_utils.h>
 #include <mc_rtc/constants.h>
 #include <mc_rtc/gui.h>
 #include <mc_rtc/type_name.h>
 
+#include <algorithm>
+#include <cmath>
+
 namespace mc_state_observation
 {
 namespace gui
@@ -87,6 +93,54 @@ auto make_input_element(const std::string & name, T & ref)
   return make_number_input(name, ref);
 }
 
+/// @brief Copy of a robot displayed in the GUI.
+/// @details The copy is refreshed from a snapshot of the joint configuration of the observed robot at the rate of the
+/// display only, so that its forward kinematics are not computed at every iteration of the controller.
+class DisplayRobot
+{
+public:
+  /// @param rate Refresh rate of the displayed robot [Hz]. The robot is refreshed at every iteration if the rate is not
+  /// positive.
+  /// @param dt Timestep of the controller.
+  void configure(double rate, double dt)
+  {
+    decimation_ = 1;
+    if(rate > 0) { decimation_ = std::max(1L, std::lround(1. / (rate * dt))); }
+  }
+
+  /// @brief Copies the robot and adds it to the GUI. The element previously added under the same name is replaced,
+  /// so that resetting the observer does not duplicate it.
+  void reset(mc_rtc::gui::StateBuilder & gui,
+             const std::vector<std::string> & category,
+             const std::string & name,
+             const mc_rbdyn::Robot & robot)
+  {
+    robots_ = mc_rbdyn::Robots::make();
+    robots_->robotCopy(robot, robot.name());
+    iter_ = 0;
+    gui.removeElement(category, name);
+    gui.addElement(category,
+                   mc_rtc::gui::Robot(name, [this]() -> const mc_rbdyn::Robot & { return robots_->robot(); }));
+  }
+
+  /// @brief Refreshes the displayed robot if its refresh is due at this iteration.
+  /// @param robot Robot whose joint configuration is displayed.
+  /// @param updateFloatingBase Sets the floating base of the displayed robot from the estimation.
+  template<typename UpdateFloatingBase>
+  void update(const mc_rbdyn::Robot & robot, UpdateFloatingBase && updateFloatingBase)
+  {
+    if(!robots_ || iter_++ % decimation_ != 0) { return; }
+    auto & displayed = robots_->robot();
+    displayed.mbc().q = robot.mbc().q;
+    updateFloatingBase(displayed);
+  }
+
+private:
+  std::shared_ptr<mc_rbdyn::Robots> robots_;
+  long decimation_ = 1;
+  long iter_ = 0;
+};
+
 } // namespace gui
 
 } // namespace mc_state_observation
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <mc_rbdyn/Robots.h>
+#include <mc_rtc/Configuration.h>
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * Capture of the inputs of an observer into a memory-mapped ring file, and replay of these inputs.
+ * The file starts with a CaptureHeader followed by a ring of fixed-size frames. Each frame contains, in this order:
+ * - a CaptureFrameHeader (iteration, controller time, monotonic clock timestamp, set of contacts),
+ * - the flattened joint configuration of the real robot (size nq),
+ * - the flattened joint configuration of the control robot (size nq),
+ * - the flattened joint velocities and accelerations of the real robot (size ndof each),
+ * - the flattened joint velocities of the control robot (size ndof),
+ * - the linear acceleration and angular velocity of each body sensor (6 doubles per sensor),
+ * - the wrench (couple, force) measured by each force sensor (6 doubles per sensor).
+ * All the values are stored in the native binary representation so that a replay restores them bit-exactly.
+ **/
+
+namespace mc_state_observation
+{
+namespace captureTools
+{
+
+struct CaptureHeader
+{
+  char magic[8]; // "MCSOCAP2"
+  uint64_t frameSize; // size of a frame in bytes
+  uint64_t capacity; // number of frames in the ring
+  uint64_t nbWritten; // total number of frames written since the creation of the file
+  uint64_t nq; // size of the flattened joint configuration
+  uint64_t ndof; // size of the flattened joint velocity
+  uint64_t nbBodySensors;
+  uint64_t nbForceSensors;
+};
+
+struct CaptureFrameHeader
+{
+  uint64_t iteration; // index of the frame since the beginning of the capture
+  double time; // time of the controller
+  int64_t timestamp; // monotonic clock timestamp in nanoseconds
+  uint64_t contacts; // bit i is set if the contact of index i is set
+};
+
+/// @brief Records the inputs of an observer at every iteration, or replays them from a previous capture.
+/// @details The file is created and mapped in memory on configuration, so that recording an iteration only copies the
+/// inputs into the mapped memory. The captured inputs are replayed into robots owned by the capture, loaded from the
+/// module of the observed robot, so that the robots of the controller are never modified.
+class InputsCapture
+{
+public:
+  enum class Mode
+  {
+    none,
+    record,
+    replay
+  };
+
+public:
+  InputsCapture() = default;
+  ~InputsCapture();
+
+  InputsCapture(const InputsCapture &) = delete;
+  InputsCapture & operator=(const InputsCapture &) = delete;
+
+  /// @brief Reads the configuration and opens the capture file.
+  /// @details Expected configuration: { mode: record|replay, path: <file>, frames: <capacity of the ring> }. Nothing
+  /// is done if the mode is "none" or not given.
+  /// @param config Capture configuration.
+  /// @param observerName Name of the observer, used for the error messages.
+  /// @param robot The robot whose inputs are captured (control robot). In replay mode, the robots receiving the
+  /// captured inputs are loaded from its module.
+  void configure(const mc_rtc::Configuration & config, const std::string & observerName, const mc_rbdyn::Robot & robot);
+
+  inline Mode mode() const noexcept { return mode_; }
+
+  /// @brief Records the inputs of the current iteration (record mode) or replays the next captured frame into the
+  /// robots of the capture (replay mode).
+  /// @param time Time of the controller.
+  /// @param robot The control robot, whose joint configuration and sensors are recorded.
+  /// @param realRobot The real robot, whose joint configuration, velocity and acceleration are recorded.
+  /// @return False if the replay reached the end of the capture.
+  bool process(double time, const mc_rbdyn::Robot & robot, const mc_rbdyn::Robot & realRobot);
+
+  /// @brief Control robot giving the inputs of the current iteration.
+  /// @return The robot containing the replayed inputs in replay mode, the given robot of the controller otherwise.
+  inline const mc_rbdyn::Robot & robot(const mc_rbdyn::Robot & ctlRobot) const
+  {
+    return mode_ == Mode::replay ? replayRobots_->robot(0) : ctlRobot;
+  }
+
+  /// @brief Real robot giving the inputs of the current iteration.
+  /// @return The real robot containing the replayed inputs in replay mode, the given real robot of the controller
+  /// otherwise.
+  inline const mc_rbdyn::Robot & realRobot(const mc_rbdyn::Robot & ctlRealRobot) const
+  {
+    return mode_ == Mode::replay ? replayRobots_->robot(1) : ctlRealRobot;
+  }
+
+  /// @brief Records the set of contacts of the current iteration (record mode) or checks that it matches the captured
+  /// one (replay mode). Only the contacts of index below 64 are captured. The first difference of a replay is reported
+  /// in the terminal, the following ones are not.
+  /// @param contacts Indexes of the currently set contacts.
+  /// @return False if the set of contacts differs from the captured one.
+  bool contacts(const std::set<int> & contacts);
+
+  /// @brief Number of frames available for the replay.
+  inline uint64_t nbFrames() const noexcept { return nbFrames_; }
+
+  void close();
+
+private:
+  // pointer to the frame of the given index in the ring
+  inline char * frame(uint64_t index) const { return data_ + (index % header_->capacity) * header_->frameSize; }
+
+  void record(char * frame, double time, const mc_rbdyn::Robot & robot, const mc_rbdyn::Robot & realRobot);
+  void replay(const char * frame, mc_rbdyn::Robot & robot, mc_rbdyn::Robot & realRobot);
+
+private:
+  Mode mode_ = Mode::none;
+  std::string observerName_;
+
+  int fd_ = -1;
+  size_t mappedSize_ = 0;
+  void * mapping_ = nullptr;
+  CaptureHeader * header_ = nullptr;
+  char * data_ = nullptr; // first frame of the ring
+
+  // frame currently recorded or replayed
+  char * currentFrame_ = nullptr;
+  // index of the next frame to replay
+  uint64_t nextFrame_ = 0;
+  // number of frames available for the replay
+  uint64_t nbFrames_ = 0;
+
+  // control robot (index 0) and real robot (index 1) into which the captured inputs are replayed
+  mc_rbdyn::RobotsPtr replayRobots_;
+  // true once a difference between the detected and the captured contacts has been reported
+  bool contactsMismatchReported_ = false;
+};
+
+/// @brief Reads the controller time of the frames available in a capture file, in the order of their replay.
+/// @param path The capture file.
+std::vector<double> readFramesTime(const std::string & path);
+
+} // namespace captureTools
+} // namespace mc_state_observation
@@ -108,10 +108,48 @@ stateObservation::kine::Kinematics & addVelsAndAccs(stateObservation::kine::Kine
 
 sva::PTransformd pTransformFromKinematics(const stateObservation::kine::Kinematics & kine);
 
+///////////////////////////////////////////////////////////////////////
+/// ---------------------------Batched poses---------------------------
+///////////////////////////////////////////////////////////////////////
+
+/// @brief Array of poses (of frames B_i within frames A_i) stored as a structure of arrays.
+/// @details Each coefficient of the orientation matrices and of the positions is stored contiguously for all the
+/// poses, so that the batched composition below processes all the poses with the same vectorized operations on rows.
+struct PoseArray
+{
+  /// row 3 * r + c contains the coefficient (r, c) of the orientation matrices
+  Eigen::Matrix<double, 9, Eigen::Dynamic, Eigen::RowMajor> orientations;
+  /// row r contains the coordinate r of the positions
+  Eigen::Matrix<double, 3, Eigen::Dynamic, Eigen::RowMajor> positions;
+
+  inline Eigen::Index size() const noexcept { return positions.cols(); }
+
+  /// @brief Resizes the array, the poses are left uninitialized.
+  void resize(Eigen::Index size);
+
+  void set(Eigen::Index i, const stateObservation::Matrix3 & orientation, const stateObservation::Vector3 & position);
+  /// @brief Sets a pose from the position and orientation of a Kinematics object.
+  void set(Eigen::Index i, const stateObservation::kine::Kinematics & kine);
+
+  stateObservation::Matrix3 orientation(Eigen::Index i) const;
+  stateObservation::Vector3 position(Eigen::Index i) const;
+  /// @brief Kinematics object containing only the pose of index i.
+  stateObservation::kine::Kinematics kinematics(Eigen::Index i) const;
+};
+
+/// @brief Composes a pose with an array of poses: out_i = a * b_i.
+/// @param a Pose of the frame B within A, only its position and orientation are used.
+/// @param out Resized if necessary, must not be the input array.
+void compose(const stateObservation::kine::Kinematics & a, const PoseArray & b, PoseArray & out);
+
 ///////////////////////////////////////////////////////////////////////
 /// -------------------------Logging functions-------------------------
 ///////////////////////////////////////////////////////////////////////
 
+/// @brief Logs the position, orientation, velocities and accelerations of a Kinematics object (zero if not set).
+/// @details The values are converted once per logged iteration into a record shared by the log entries.
+/// @param kine The logged Kinematics, must outlive the log entries.
+/// @param prefix Prefix of the log entries.
 void addToLogger(const stateObservation::kine::Kinematics & kine, mc_rtc::Logger & logger, const std::string & prefix);
 
 void removeFromLogger(mc_rtc::Logger & logger, const std::string & prefix);
@@ -101,16 +101,36 @@ protected:
   }
 };
 
-/// @brief Structure that implements all the necessary functions to perform legged odometry.
-/// @details Handles the odometry from the contacts detection to the final pose estimation of the floating base. Also
-/// allows to compute the pose of an anchor frame linked to the robot.
-struct LeggedOdometryManager
+} // namespace leggedOdometry
+
+namespace measurements
+{
+// the contacts manager of the legged odometry is compiled once in the library (see leggedOdometryTools.cpp) instead of
+// in every observer using it
+extern template struct MapContacts<leggedOdometry::LoContactWithSensor, leggedOdometry::LoContactWithoutSensor>;
+extern template struct ContactsManager<leggedOdometry::LoContactWithSensor, leggedOdometry::LoContactWithoutSensor>;
+} // namespace measurements
+
+namespace leggedOdometry
+{
+
+/// @brief Computational core of the legged odometry, independent from any controller.
+/// @details Contains the odometry robot, the contacts and all the computations from the joint configuration, the
+/// measured contact forces and the tilt to the pose (and velocity) of the floating base and the reference kinematics of
+/// the contacts. It does not use the controller, the logger or the GUI, so it can be run on recorded data (for example
+/// with robots loaded from their module), and several instances can run concurrently on different threads.
+/// A typical iteration calls \ref beginIteration(const mc_rbdyn::Robot &), detects the contacts with
+/// contactsManager().findContacts(const mc_rbdyn::Robot &) (or gives them with contactsManager().setContactsFound())
+/// and then calls \ref updateFbAndContacts(const mc_rbdyn::Robot &, const mc_rbdyn::Robot &, double, const bool,
+/// const bool, const stateObservation::Matrix3 &). \ref run(const mc_rbdyn::Robot &, const mc_rbdyn::Robot &, double,
+/// const stateObservation::Matrix3 &, const bool, const bool) performs these three steps.
+struct LeggedOdometryCore
 {
 public:
   typedef measurements::ContactsManager<LoContactWithSensor, LoContactWithoutSensor> ContactsManager;
 
 public:
-  LeggedOdometryManager() {}
+  LeggedOdometryCore() {}
 
 protected:
   ///////////////////////////////////////////////////////////////////////
@@ -136,6 +156,251 @@ protected:
     std::set<std::reference_wrapper<LoContactWithSensor>, sortByForce> oriOdometryContacts_;
   };
 
+public:
+  /// @brief Initializer for the odometry core.
+  /// @param robot The robot whose floating base is estimated. The odometry robot is initialized as a copy of it.
+  /// @param odometryName Name of the odometry, used in the messages.
+  /// @param odometryType Indicates if the desired odometry must be a flat or a 6D odometry.
+  /// @param withYawEstimation Indicates if the orientation must be estimated by this odometry.
+  /// @param velUpdatedUpstream Informs whether the 6D velocity was updated by upstream observers
+  /// @param accUpdatedUpstream Informs whether the acceleration was updated by upstream observers
+  /// @param verbose
+  void init(const mc_rbdyn::Robot & robot,
+            const std::string & odometryName,
+            const measurements::OdometryType & odometryType,
+            const bool withYawEstimation,
+            const bool velUpdatedUpstream,
+            const bool accUpdatedUpstream,
+            const bool verbose);
+
+  /// @brief Initialization for a detection based on contact surfaces.
+  /// @copydetails ContactsManager::initDetection(const mc_rbdyn::Robot &, const ContactsDetection &, const
+  /// std::vector<std::string> &, const std::vector<std::string> &, const double &)
+  void initDetection(const mc_rbdyn::Robot & robot,
+                     const ContactsManager::ContactsDetection & contactsDetection,
+                     const std::vector<std::string> & surfacesForContactDetection,
+                     const std::vector<std::string> & contactsSensorDisabledInit,
+                     const double & contactDetectionThreshold);
+
+  /// @brief Initialization for a detection based on a threshold on the measured contact forces.
+  /// @copydetails ContactsManager::initDetection(const mc_rbdyn::Robot &, const ContactsDetection &, const
+  /// std::vector<std::string> &, const double &, const std::vector<std::string> &)
+  void initDetection(const mc_rbdyn::Robot & robot,
+                     const ContactsManager::ContactsDetection & contactsDetection,
+                     const std::vector<std::string> & contactsSensorDisabledInit,
+                     const double & contactDetectionThreshold,
+                     const std::vector<std::string> & forceSensorsToOmit);
+
+  /// @brief Runs one iteration of the odometry, with the contacts detected from the measured forces.
+  /// @details The estimated kinematics of the floating base are then the ones of odometryRobot().
+  /// @param robot Robot containing the force measurements (the control robot in a controller).
+  /// @param realRobot Robot containing the joint configuration, and the velocity and acceleration of the floating base
+  /// if they are updated upstream.
+  /// @param dt Time step, used to compute the velocity by finite differences if it is not updated upstream.
+  /// @param tilt The floating base's tilt (only the yaw is estimated).
+  /// @param updateVels Indicates if the 6D velocity of the floating base must be updated
+  /// @param updateAccs Indicates if the acceleration of the floating base must be updated
+  void run(const mc_rbdyn::Robot & robot,
+           const mc_rbdyn::Robot & realRobot,
+           double dt,
+           const stateObservation::Matrix3 & tilt,
+           const bool updateVels,
+           const bool updateAccs);
+
+  /// @brief Copies the joint configuration of the real robot into the odometry robot and resets its floating base to
+  /// the last estimation. Has to be called at the beginning of each iteration.
+  /// @param realRobot Robot containing the joint configuration.
+  void beginIteration(const mc_rbdyn::Robot & realRobot);
+
+  /// @brief Updates the joints configuration of the odometry robot.
+  /// @param realRobot Robot containing the joint configuration.
+  void updateJointsConfiguration(const mc_rbdyn::Robot & realRobot);
+
+  /// @brief Updates the pose of the contacts and estimates the floating base from them.
+  /// @details The newly set contacts are given their reference kinematics in the world.
+  /// @param robot Robot containing the force measurements.
+  /// @param realRobot Robot containing the velocity and acceleration of the floating base if they are updated
+  /// upstream.
+  /// @param dt Time step.
+  /// @param updateVels Indicates if the 6D velocity of the floating base must be updated
+  /// @param updateAccs Indicates if the acceleration of the floating base must be updated
+  /// @param tilt The floating base's tilt (only the yaw is estimated).
+  void updateFbAndContacts(const mc_rbdyn::Robot & robot,
+                           const mc_rbdyn::Robot & realRobot,
+                           double dt,
+                           const bool updateVels,
+                           const bool updateAccs,
+                           const stateObservation::Matrix3 & tilt);
+
+  /// @brief If the contacts respect the conditions, computes the pose of the floating base for each set contact.
+  /// @details Combines the reference pose of the contact in the world and the transformation from the contact to the
+  /// frame. The position of the floating base is updated in the same pass with the force-weighted average of the
+  /// positions obtained from each contact.
+  /// @param robot Robot containing the force measurements.
+  /// @param posUpdatable Indicates if the position can be updated using contacts
+  /// @param oriUpdatable Indicates if the orientation can be updated using contacts
+  /// @param sumForces_position Sum of the measured force of all the contacts that will be used for the position
+  /// estimation
+  /// @param sumForces_orientation Sum of the measured force of all the contacts that will be used for the orientation
+  /// estimation
+  void getFbFromContacts(const mc_rbdyn::Robot & robot,
+                         bool & posUpdatable,
+                         bool & oriUpdatable,
+                         double & sumForces_position,
+                         double & sumForces_orientation);
+
+  /// @brief Updates the floating base kinematics of the odometry robot with the new estimation.
+  /// @details Beware, only the pose is updated by the odometry, the 6D velocity (except if not updated by an upstream
+  /// observer) and acceleration update only performs a transformation from the real robot to our newly estimated
+  /// robot. If you want to update the acceleration of the floating base, you need to add an observer computing them
+  /// beforehand.
+  /// @param realRobot Robot containing the velocity and acceleration of the floating base if they are updated
+  /// upstream.
+  /// @param dt Time step, used to compute the velocity by finite differences if it is not updated upstream and no
+  /// contact can be used to compute it.
+  /// @param updateVels If true, the velocity of the floating base of the odometry robot is updated from the one of
+  /// the real robot, or computed from the contacts if it is not updated upstream.
+  /// @param updateAccs If true, the acceleration of the floating base of the odometry robot is updated from the one
+  /// of the real robot. This acceleration must be computed by an upstream observer..
+  void updateOdometryRobot(const mc_rbdyn::Robot & realRobot,
+                           double dt,
+                           const bool updateVels,
+                           const bool updateAccs);
+
+  /// @brief Computes the velocity of the floating base from the joint velocities, assuming the set contacts don't
+  /// move.
+  /// @details Each contact that was already set gives the 6 constraints J_fb v_fb + J_q alpha = 0 on its velocity. The
+  /// velocity of the floating base is the force-weighted least-squares solution of these constraints, obtained from
+  /// 6x6 normal equations. The joint contributions J_q alpha are computed from the joint velocities of the real robot
+  /// along the kinematic chain of the odometry robot, which is not modified. Must be called after \ref
+  /// getFbFromContacts(const mc_rbdyn::Robot &, bool &, bool &, double &, double &), which computes the current
+  /// kinematics of the contacts.
+  /// @param realRobot Robot containing the joint velocities.
+  /// @param localVel Velocity of the floating base, expressed in the frame of the floating base.
+  /// @return False if no contact can be used to compute the velocity.
+  bool getFbVelocityFromContacts(const mc_rbdyn::Robot & realRobot, sva::MotionVecd & localVel);
+
+  /// @brief Updates the floating base kinematics given as argument by the observer.
+  /// @details Beware, only the pose is updated by the odometry, the 6D velocity (except if not updated by an upstream
+  /// observer) and acceleration update only performs a transformation from the real robot to our newly estimated
+  /// robot. If you want to update the acceleration of the floating base, you need to add an observer computing them
+  /// beforehand.
+  /// @param pose The pose of the floating base in the world that we want to update
+  /// @param vel The 6D velocity of the floating base in the world that we want to update.
+  /// @param acc The acceleration of the floating base in the world that we want to update. This acceleration must
+  /// come from an upstream observer.
+  void updateFbKinematics(sva::PTransformd & pose, sva::MotionVecd & vel, sva::MotionVecd & acc);
+
+  /// @brief Updates the floating base kinematics given as argument by the observer.
+  /// @details Beware, only the pose is updated by the odometry, the 6D velocity update only performs a transformation
+  /// from the real robot to our newly estimated robot.
+  /// @param pose The pose of the floating base in the world that we want to update
+  /// @param vel The 6D velocity of the floating base in the world that we want to update.
+  void updateFbKinematics(sva::PTransformd & pose, sva::MotionVecd & vel);
+
+  /// @brief Updates the floating base kinematics given as argument by the observer.
+  /// @param pose The pose of the floating base in the world that we want to update
+  void updateFbKinematics(sva::PTransformd & pose);
+
+  /// @brief Computes the reference kinematics of the newly set contact in the world.
+  /// @param contact The new contact
+  /// @param measurementsRobot The robot containing the contact's force sensor
+  void setNewContact(LoContactWithSensor & contact, const mc_rbdyn::Robot & measurementsRobot);
+
+  /// @brief Computes the kinematics of the contact attached to the odometry robot in the world frame.
+  /// @param contact Contact of which we want to compute the kinematics
+  /// @param fs The force sensor associated to the contact
+  /// @return stateObservation::kine::Kinematics &
+  const stateObservation::kine::Kinematics & getCurrentContactKinematics(LoContactWithSensor & contact,
+                                                                         const mc_rbdyn::ForceSensor & fs);
+
+  /// @brief Select which contacts to use for the orientation odometry
+  /// @details The two contacts with the highest measured force are selected. The contacts at hands are ignored because
+  /// their orientation is less trustable.
+  void selectForOrientationOdometry();
+
+  /// @brief Returns the pose of the odometry robot's anchor frame based on the current floating base and encoders.
+  /// @details The anchor frame can be obtained using 2 ways:
+  /// - 1: contacts are detected and can be used to compute the anchor frame.
+  /// - 2: no contact is detected, the robot is hanging. If we still need an anchor frame for the tilt estimation we
+  /// arbitrarily use the frame of the bodySensor used by the estimator.
+  /// @param robot Robot containing the force measurements.
+  /// @param bodySensorName name of the body sensor.
+  stateObservation::kine::Kinematics & getAnchorFramePose(const mc_rbdyn::Robot & robot,
+                                                          const std::string & bodySensorName);
+
+  /// @brief Returns the pose of the odometry robot's anchor frame. If no contact is detected, this version does not
+  /// update the anchor frame.
+  /// @param robot Robot containing the force measurements.
+  stateObservation::kine::Kinematics & getAnchorFramePose(const mc_rbdyn::Robot & robot);
+
+  /// @brief Changes the type of the odometry
+  /// @param newOdometryType The new type of odometry to use.
+  void changeOdometryType(const std::string & newOdometryType);
+
+  /// @brief Changes the type of the odometry.
+  /// @details Version meant to be called by the observer using the odometry.
+  /// @param newOdometryType The new type of odometry to use.
+  void changeOdometryType(const measurements::OdometryType & newOdometryType);
+
+  /// @brief Getter for the odometry robot used for the estimation.
+  mc_rbdyn::Robot & odometryRobot() { return odometryRobot_->robot("odometryRobot"); }
+
+  /// @brief Getter for the contacts manager.
+  LeggedOdometryContactsManager & contactsManager() { return contactsManager_; }
+
+public:
+  // Indicates if the mode of computation of the anchor frame changed. Might me needed by the estimator (ex;
+  // TiltObserver)
+  bool prevAnchorFromContacts_ = true;
+  // Indicates if the desired odometry must be a flat or a 6D odometry.
+  using OdometryType = measurements::OdometryType;
+  measurements::OdometryType odometryType_;
+
+protected:
+  // Name of the odometry, used in logs and in the gui.
+  std::string odometryName_;
+
+  // indicates whether we want to update the yaw using this method or not
+  bool withYawEstimation_;
+  // tracked pose of the floating base
+  sva::PTransformd fbPose_ = sva::PTransformd::Identity();
+
+protected:
+  // contacts manager used by this odometry manager
+  LeggedOdometryContactsManager contactsManager_;
+  // odometry robot that is updated by the legged odometry and can then update the real robot if required.
+  std::shared_ptr<mc_rbdyn::Robots> odometryRobot_;
+  // pose of the anchor frame of the robot in the world
+  stateObservation::kine::Kinematics worldAnchorPose_;
+
+  // Indicates whether the velocity is updated by an upstream estimator. If yes, it is expressed in the newly obtained
+  // floating base frame. Otherwise, it is computed from the joint velocities and the set contacts, or by finite
+  // differences if there is no contact.
+  bool velUpdatedUpstream_ = false;
+  // Indicates whether the acceleration is updated by an upstream estimator. If yes, it is expressed in the newly
+  // obtained floating base frame. Otherwise, it is not updated.
+  bool accUpdatedUpstream_ = false;
+};
+
+/// @brief Structure that implements all the necessary functions to perform legged odometry within a controller.
+/// @details Handles the odometry from the contacts detection to the final pose estimation of the floating base. Also
+/// allows to compute the pose of an anchor frame linked to the robot. The computations are performed by the
+/// LeggedOdometryCore, this structure fetches their inputs from the controller and handles the logs and the GUI.
+struct LeggedOdometryManager : public LeggedOdometryCore
+{
+public:
+  LeggedOdometryManager() {}
+
+  using LeggedOdometryCore::getAnchorFramePose;
+  using LeggedOdometryCore::getFbFromContacts;
+  using LeggedOdometryCore::init;
+  using LeggedOdometryCore::initDetection;
+  using LeggedOdometryCore::run;
+  using LeggedOdometryCore::updateFbAndContacts;
+  using LeggedOdometryCore::updateJointsConfiguration;
+  using LeggedOdometryCore::updateOdometryRobot;
+
 public:
   /// @brief Initializer for the odometry manager.
   /// @details Version for the contact detection using a thresholding on the contact force sensors measurements or by
@@ -267,9 +532,7 @@ public:
                            const bool updateAccs,
                            const stateObservation::Matrix3 & tilt);
 
-  /// @brief If the contacts respect the conditions, computes the pose of the floating base for each set contact.
-  /// @details Combines the reference pose of the contact in the world and the transformation from the contact to the
-  /// frame.
+  /// @brief @copybrief LeggedOdometryCore::getFbFromContacts
   /// @param ctl Controller.
   /// @param posUpdatable Indicates if the position can be updated using contacts
   /// @param oriUpdatable Indicates if the orientation can be updated using contacts
@@ -296,75 +559,16 @@ public:
   /// of the real robot. This acceleration must be computed by an upstream observer..
   void updateOdometryRobot(const mc_control::MCController & ctl, const bool updateVels, const bool updateAccs);
 
-  /// @brief Updates the floating base kinematics given as argument by the observer.
-  /// @details Beware, only the pose is updated by the odometry, the 6D velocity (except if not updated by an upstream
-  /// observer) and acceleration update only performs a transformation from the real robot to our newly estimated
-  /// robot. If you want to update the acceleration of the floating base, you need to add an observer computing them
-  /// beforehand.
-  /// @param ctl Controller
-  /// @param pose The pose of the floating base in the world that we want to update
-  /// @param vel The 6D velocity of the floating base in the world that we want to update.
-  /// @param acc The acceleration of the floating base in the world that we want to update. This acceleration must
-  /// come from an upstream observer.
-  /// @param logger logger
-  void updateFbKinematics(sva::PTransformd & pose, sva::MotionVecd & vel, sva::MotionVecd & acc);
-
-  /// @brief Updates the floating base kinematics given as argument by the observer.
-  /// @details Beware, only the pose is updated by the odometry, the 6D velocity update only performs a transformation
-  /// from the real robot to our newly estimated robot.
-  /// @param ctl Controller
-  /// @param pose The pose of the floating base in the world that we want to update
-  /// @param vel The 6D velocity of the floating base in the world that we want to update.
-  /// @param logger logger
-  void updateFbKinematics(sva::PTransformd & pose, sva::MotionVecd & vel);
-
-  /// @brief Updates the floating base kinematics given as argument by the observer.
-  /// @param ctl Controller
-  /// @param pose The pose of the floating base in the world that we want to update
-  /// @param logger logger
-  void updateFbKinematics(sva::PTransformd & pose);
-
-  /// @brief Computes the reference kinematics of the newly set contact in the world.
-  /// @param contact The new contact
-  /// @param measurementsRobot The robot containing the contact's force sensor
-  void setNewContact(LoContactWithSensor & contact, const mc_rbdyn::Robot & measurementsRobot);
-
-  /// @brief Computes the kinematics of the contact attached to the odometry robot in the world frame.
-  /// @param contact Contact of which we want to compute the kinematics
-  /// @param fs The force sensor associated to the contact
-  /// @return stateObservation::kine::Kinematics &
-  const stateObservation::kine::Kinematics & getCurrentContactKinematics(LoContactWithSensor & contact,
-                                                                         const mc_rbdyn::ForceSensor & fs);
-
-  /// @brief Select which contacts to use for the orientation odometry
-  /// @details The two contacts with the highest measured force are selected. The contacts at hands are ignored because
-  /// their orientation is less trustable.
-  void selectForOrientationOdometry();
-
-  /// @brief Returns the pose of the odometry robot's anchor frame based on the current floating base and encoders.
-  /// @details The anchor frame can be obtained using 2 ways:
-  /// - 1: contacts are detected and can be used to compute the anchor frame.
-  /// - 2: no contact is detected, the robot is hanging. If we still need an anchor frame for the tilt estimation we
-  /// arbitrarily use the frame of the bodySensor used by the estimator.
+  /// @brief @copybrief LeggedOdometryCore::getAnchorFramePose(const mc_rbdyn::Robot &, const std::string &)
   /// @param ctl controller
   /// @param bodySensorName name of the body sensor.
   stateObservation::kine::Kinematics & getAnchorFramePose(const mc_control::MCController & ctl,
                                                           const std::string & bodySensorName);
 
-  /// @brief Returns the pose of the odometry robot's anchor frame. If no contact is detected, this version does not
-  /// update the anchor frame.
+  /// @brief @copybrief LeggedOdometryCore::getAnchorFramePose(const mc_rbdyn::Robot &)
   /// @param ctl controller
   stateObservation::kine::Kinematics & getAnchorFramePose(const mc_control::MCController & ctl);
 
-  /// @brief Changes the type of the odometry
-  /// @param newOdometryType The new type of odometry to use.
-  void changeOdometryType(const std::string & newOdometryType);
-
-  /// @brief Changes the type of the odometry.
-  /// @details Version meant to be called by the observer using the odometry.
-  /// @param newOdometryType The new type of odometry to use.
-  void changeOdometryType(const measurements::OdometryType & newOdometryType);
-
   /// @brief Add the log entries corresponding to the contact.
   /// @param logger
   /// @param contactName
@@ -375,45 +579,39 @@ public:
   /// @param contactName
   void removeContactLogEntries(mc_rtc::Logger & logger, const LoContactWithSensor & contact);
 
-  /// @brief Getter for the odometry robot used for the estimation.
-  mc_rbdyn::Robot & odometryRobot() { return odometryRobot_->robot("odometryRobot"); }
+  /// @brief Gives the robots whose measurements are used instead of the ones of the controller, for example the robots
+  /// into which captured inputs are replayed. The contacts given by the solver are still read from the controller.
+  /// @param robot Control robot, nullptr to use the one of the controller.
+  /// @param realRobot Real robot, nullptr to use the one of the controller.
+  inline void setInputRobots(const mc_rbdyn::Robot * robot, const mc_rbdyn::Robot * realRobot)
+  {
+    inputRobot_ = robot;
+    inputRealRobot_ = realRobot;
+  }
 
-  /// @brief Getter for the contacts manager.
-  LeggedOdometryContactsManager & contactsManager() { return contactsManager_; }
+protected:
+  /// @brief Control robot giving the measurements of the odometry.
+  inline const mc_rbdyn::Robot & inputRobot(const mc_rbdyn::Robot & ctlRobot) const
+  {
+    return inputRobot_ != nullptr ? *inputRobot_ : ctlRobot;
+  }
 
-public:
-  // Indicates if the mode of computation of the anchor frame changed. Might me needed by the estimator (ex;
-  // TiltObserver)
-  bool prevAnchorFromContacts_ = true;
-  // Indicates if the desired odometry must be a flat or a 6D odometry.
-  using OdometryType = measurements::OdometryType;
-  measurements::OdometryType odometryType_;
+  /// @brief Real robot giving the measurements of the odometry.
+  inline const mc_rbdyn::Robot & inputRealRobot(const mc_rbdyn::Robot & ctlRealRobot) const
+  {
+    return inputRealRobot_ != nullptr ? *inputRealRobot_ : ctlRealRobot;
+  }
+
+  /// @brief Detects the contacts currently set, from the input robot or from the solver of the controller.
+  void findContacts(const mc_control::MCController & ctl);
 
 protected:
-  // Name of the odometry, used in logs and in the gui.
-  std::string odometryName_;
   // Name of the robot
   std::string robotName_;
 
-  // indicates whether we want to update the yaw using this method or not
-  bool withYawEstimation_;
-  // tracked pose of the floating base
-  sva::PTransformd fbPose_ = sva::PTransformd::Identity();
-
-protected:
-  // contacts manager used by this odometry manager
-  LeggedOdometryContactsManager contactsManager_;
-  // odometry robot that is updated by the legged odometry and can then update the real robot if required.
-  std::shared_ptr<mc_rbdyn::Robots> odometryRobot_;
-  // pose of the anchor frame of the robot in the world
-  stateObservation::kine::Kinematics worldAnchorPose_;
-
-  // Indicates whether the velocity is updated by an upstream estimator. If yes, it is expressed in the newly obtained
-  // floating base frame. Otherwise, it is computed by finite differences.
-  bool velUpdatedUpstream_ = false;
-  // Indicates whether the acceleration is updated by an upstream estimator. If yes, it is expressed in the newly
-  // obtained floating base frame. Otherwise, it is not updated.
-  bool accUpdatedUpstream_ = false;
+  // robots used instead of the ones of the controller if not null
+  const mc_rbdyn::Robot * inputRobot_ = nullptr;
+  const mc_rbdyn::Robot * inputRealRobot_ = nullptr;
 };
 
 } // namespace leggedOdometry
@@ -585,6 +585,33 @@ public:
                      const double & contactDetectionThreshold,
                      const std::vector<std::string> & forceSensorsToOmit);
 
+  /// @brief Initialization for a detection based on contact surfaces, without controller.
+  /// @details The contacts are not added to the GUI.
+  /// @param robot robot containing the surfaces and force sensors
+  /// @param contactsDetection mean of detection for the contacts
+  /// @param surfacesForContactDetection list of possible contact surfaces
+  /// @param contactsSensorDisabledInit list of the force sensors that must be disabled on initialization.
+  /// @param contactDetectionThreshold threshold on the measured force for the contact detection
+  void initDetection(const mc_rbdyn::Robot & robot,
+                     const ContactsDetection & contactsDetection,
+                     const std::vector<std::string> & surfacesForContactDetection,
+                     const std::vector<std::string> & contactsSensorDisabledInit,
+                     const double & contactDetectionThreshold);
+
+  /// @brief Initialization for a detection based on a threshold on the measured contact forces or for contacts given by
+  /// the controller, without controller.
+  /// @details The contacts are not added to the GUI.
+  /// @param robot robot containing the force sensors
+  /// @param contactsDetection mean of detection for the contacts
+  /// @param contactsSensorDisabledInit list of the force sensors that must be disabled on initialization.
+  /// @param contactDetectionThreshold threshold on the measured force for the contact detection
+  /// @param forceSensorsToOmit list of force sensors that cannot be used for the contacts detection
+  void initDetection(const mc_rbdyn::Robot & robot,
+                     const ContactsDetection & contactsDetection,
+                     const std::vector<std::string> & contactsSensorDisabledInit,
+                     const double & contactDetectionThreshold,
+                     const std::vector<std::string> & forceSensorsToOmit);
+
   /// @brief Adds the contact to the GUI to enable or disable it easily.
   /// @details Version for a contact associated to a force sensor.
   /// @param ctl The controller.
@@ -619,6 +646,19 @@ public:
   /// "fromThreshold". The contacts are not required to be given by the controller (the detection is based on a
   /// thresholding of the measured force).
   void findContactsFromThreshold(const mc_control::MCController & ctl, const std::string & robotName);
+  /// @brief Updates the list of currently set contacts from the measured forces and returns it.
+  /// @details Version that doesn't require a controller, for the detection from surfaces or from a threshold on the
+  /// measured force.
+  /// @param measRobot robot containing the force measurements.
+  const ContactsSet & findContacts(const mc_rbdyn::Robot & measRobot);
+  /// @brief Updates the list @contactsFound_ of currently set contacts by thresholding the force measured by the sensor
+  /// associated to each contact.
+  /// @param measRobot robot containing the force measurements.
+  void findContactsFromForces(const mc_rbdyn::Robot & measRobot);
+  /// @brief Sets the list of currently set contacts, detected externally (for example from recorded data), and returns
+  /// it.
+  /// @param contactsFound indexes of the currently set contacts.
+  const ContactsSet & setContactsFound(const ContactsSet & contactsFound);
   /// @brief Updates the list of contacts to inform whether they are newly set, removed, etc.
   void updateContacts();
 
@@ -664,7 +704,7 @@ public:
   /// @brief Accessor for the a contact that is not associated to a sensor contained in the map
   /// @param name The contact itself.
   /// @return ContactWithoutSensor&
-  inline ContactWithoutSensorT & contactWithoutSensor(const ContactWithoutSensorT & contact) { return contact; }
+  inline ContactWithoutSensorT & contactWithoutSensor(ContactWithoutSensorT & contact) { return contact; }
 
   /// @brief Get the map of all the contacts associated to a sensor
   ///
@@ -27,6 +27,20 @@ void ContactsManager<ContactWithSensorT, ContactWithoutSensorT>::initDetection(
     const std::vector<std::string> & contactsSensorDisabledInit,
     const double & contactDetectionThreshold)
 {
+  initDetection(ctl.robot(robotName), contactsDetection, surfacesForContactDetection, contactsSensorDisabledInit,
+                contactDetectionThreshold);
+
+  for(const std::string & surface : mapContacts_.getList()) { addContactToGui(ctl, surface, true); }
+}
+
+template<typename ContactWithSensorT, typename ContactWithoutSensorT>
+void ContactsManager<ContactWithSensorT, ContactWithoutSensorT>::initDetection(
+    const mc_rbdyn::Robot & robot,
+    const ContactsDetection & contactsDetection,
+    const std::vector<std::string> & surfacesForContactDetection,
+    const std::vector<std::string> & contactsSensorDisabledInit,
+    const double & contactDetectionThreshold)
+{
 
   contactsFinder_ = &ContactsManager<ContactWithSensorT, ContactWithoutSensorT>::findContactsFromSurfaces;
 
@@ -34,14 +48,13 @@ void ContactsManager<ContactWithSensorT, ContactWithoutSensorT>::initDetection(
   surfacesForContactDetection_ = surfacesForContactDetection;
   contactsSensorDisabledInit_ = contactsSensorDisabledInit;
 
-  const auto & robot = ctl.robot(robotName);
-
   if(contactsDetection != fromSolver && contactsDetection != fromThreshold && contactsDetection != fromSurfaces)
   {
     mc_rtc::log::error_and_throw<std::runtime_error>(
         "Contacts detection type not allowed. Please pick among : [fromSolver, fromThreshold, fromSurfaces] or "
         "initialize a list of surfaces with the variable surfacesForContactDetection");
   }
+  contactsDetectionMethod_ = contactsDetection;
 
   if(surfacesForContactDetection.size() > 0)
   {
@@ -68,7 +81,6 @@ void ContactsManager<ContactWithSensorT, ContactWithoutSensorT>::initDetection(
         const mc_rbdyn::ForceSensor & forceSensor = robot.surfaceForceSensor(surface);
         const std::string & fsName = forceSensor.name();
         mapContacts_.insertContact(fsName, surface, true);
-        addContactToGui(ctl, surface, true);
       }
       else // if the surface is not associated to a force sensor, we will fetch the force sensor indirectly attached to
            // the surface
@@ -76,7 +88,6 @@ void ContactsManager<ContactWithSensorT, ContactWithoutSensorT>::initDetection(
         const mc_rbdyn::ForceSensor & forceSensor = robot.indirectSurfaceForceSensor(surface);
         const std::string & fsName = forceSensor.name();
         mapContacts_.insertContact(fsName, surface, false);
-        addContactToGui(ctl, surface, true);
       }
     }
   }
@@ -96,6 +107,20 @@ void ContactsManager<ContactWithSensorT, ContactWithoutSensorT>::initDetection(
     const std::vector<std::string> & contactsSensorDisabledInit,
     const double & contactDetectionThreshold,
     const std::vector<std::string> & forceSensorsToOmit)
+{
+  initDetection(ctl.robot(robotName), contactsDetection, contactsSensorDisabledInit, contactDetectionThreshold,
+                forceSensorsToOmit);
+
+  for(const std::string & fsName : mapContacts_.getList()) { addContactToGui(ctl, fsName); }
+}
+
+template<typename ContactWithSensorT, typename ContactWithoutSensorT>
+void ContactsManager<ContactWithSensorT, ContactWithoutSensorT>::initDetection(
+    const mc_rbdyn::Robot & robot,
+    const ContactsDetection & contactsDetection,
+    const std::vector<std::string> & contactsSensorDisabledInit,
+    const double & contactDetectionThreshold,
+    const std::vector<std::string> & forceSensorsToOmit)
 {
   if(contactsDetection == fromSolver)
   {
@@ -109,8 +134,6 @@ void ContactsManager<ContactWithSensorT, ContactWithoutSensorT>::initDetection(
   contactDetectionThreshold_ = contactDetectionThreshold;
   contactsSensorDisabledInit_ = contactsSensorDisabledInit;
 
-  const auto & robot = ctl.robot(robotName);
-
   if(contactsDetection != fromSolver && contactsDetection != fromThreshold && contactsDetection != fromSurfaces)
   {
     mc_rtc::log::error_and_throw<std::runtime_error>(
@@ -124,6 +147,7 @@ void ContactsManager<ContactWithSensorT, ContactWithoutSensorT>::initDetection(
         "You selected the contacts detection using surfaces but didn't add the list of surfaces, please use the "
         "ContactsManager constructor that receives this surfaces list");
   }
+  contactsDetectionMethod_ = contactsDetection;
 
   if(contactsDetection == fromThreshold)
   {
@@ -137,7 +161,6 @@ void ContactsManager<ContactWithSensorT, ContactWithoutSensorT>::initDetection(
       const std::string & fsName = forceSensor.name();
 
       mapContacts_.insertContact(fsName, true);
-      addContactToGui(ctl, fsName);
     }
   }
 
@@ -284,22 +307,8 @@ void ContactsManager<ContactWithSensorT, ContactWithoutSensorT>::findContactsFro
     const mc_control::MCController & ctl,
     const std::string & robotName)
 {
-  const auto & measRobot = ctl.robot(robotName);
-
-  contactsFound_.clear();
-
-  for(auto & contact : mapContacts_.contactsWithSensors())
-  {
-    const std::string & fsName = contact.second.forceSensorName();
-    const mc_rbdyn::ForceSensor forceSensor = measRobot.forceSensor(fsName);
-
-    contact.second.forceNorm_ = forceSensor.wrenchWithoutGravity(measRobot).force().norm();
-    if(contact.second.forceNorm_ > contactDetectionThreshold_)
-    {
-      //  the contact is added to the map of contacts using the name of the associated surface
-      contactsFound_.insert(contact.second.getID());
-    }
-  }
+  //  the contacts are detected from the force measured by the sensor associated to each surface
+  findContactsFromForces(ctl.robot(robotName));
 }
 
 template<typename ContactWithSensorT, typename ContactWithoutSensorT>
@@ -307,23 +316,55 @@ void ContactsManager<ContactWithSensorT, ContactWithoutSensorT>::findContactsFro
     const mc_control::MCController & ctl,
     const std::string & robotName)
 {
-  const auto & measRobot = ctl.robot(robotName);
+  findContactsFromForces(ctl.robot(robotName));
+}
+
+template<typename ContactWithSensorT, typename ContactWithoutSensorT>
+const std::set<int> & ContactsManager<ContactWithSensorT, ContactWithoutSensorT>::findContacts(
+    const mc_rbdyn::Robot & measRobot)
+{
+  if(contactsDetectionMethod_ != fromSurfaces && contactsDetectionMethod_ != fromThreshold)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>(
+        "[{}] The contacts can be detected without controller only from surfaces or from a threshold on the measured "
+        "forces.",
+        observerName_);
+  }
+  findContactsFromForces(measRobot);
+  updateContacts();
 
+  return contactsFound_; // list of currently set contacts
+}
+
+template<typename ContactWithSensorT, typename ContactWithoutSensorT>
+void ContactsManager<ContactWithSensorT, ContactWithoutSensorT>::findContactsFromForces(
+    const mc_rbdyn::Robot & measRobot)
+{
   contactsFound_.clear();
 
   for(auto & contact : mapContacts_.contactsWithSensors())
   {
     const std::string & fsName = contact.second.forceSensorName();
-    const mc_rbdyn::ForceSensor forceSensor = measRobot.forceSensor(fsName);
+    const mc_rbdyn::ForceSensor & forceSensor = measRobot.forceSensor(fsName);
     contact.second.forceNorm_ = forceSensor.wrenchWithoutGravity(measRobot).force().norm();
     if(contact.second.forceNorm_ > contactDetectionThreshold_)
     {
-      // the contact is added to the map of contacts using the name of the associated sensor
+      // the contact is added to the map of contacts using the name of the associated sensor or surface
       contactsFound_.insert(contact.second.getID());
     }
   }
 }
 
+template<typename ContactWithSensorT, typename ContactWithoutSensorT>
+const std::set<int> & ContactsManager<ContactWithSensorT, ContactWithoutSensorT>::setContactsFound(
+    const ContactsSet & contactsFound)
+{
+  contactsFound_ = contactsFound;
+  updateContacts();
+
+  return contactsFound_;
+}
+
 template<typename ContactWithSensorT, typename ContactWithoutSensorT>
 void ContactsManager<ContactWithSensorT, ContactWithoutSensorT>::updateContacts()
 {
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <mc_rtc/Configuration.h>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Threading utilities for the observers. The WorkerPool is a fixed set of threads created once (outside of the control
+ * loop) that execute indexed tasks on demand, the calling thread taking part in the execution. Dispatching a batch of
+ * tasks does not allocate memory.
+ * The LatestValueSlot passes the latest value produced by a thread (for example a thread receiving measurements) to the
+ * control thread without locks.
+ **/
+
+namespace mc_state_observation
+{
+namespace threadingTools
+{
+
+/// @brief Pins a thread to the given set of cpus.
+/// @param thread The thread to pin.
+/// @param cpus Indexes of the cpus the thread is allowed to run on. Nothing is done if the list is empty.
+/// @return False if the affinity could not be set.
+bool setThreadAffinity(std::thread & thread, const std::vector<int> & cpus);
+
+/// @brief Sets the scheduling policy and the priority of a thread.
+/// @param thread The thread to configure.
+/// @param policy Scheduling policy, among other, batch, idle, fifo and rr.
+/// @param priority Static priority of the thread. Only used by the real-time policies (fifo and rr).
+/// @return False if the policy is unknown or could not be set (the real-time policies require privileges).
+bool setThreadScheduling(std::thread & thread, const std::string & policy, int priority);
+
+/// @brief Applies the cpu affinity, the scheduling policy and the priority given in the configuration to a background
+/// thread of an observer.
+/// @details Expected configuration: { cpus: <cpus the thread may run on, default: all>, policy:
+/// other|batch|idle|fifo|rr (default: unchanged), priority: <static priority for fifo and rr, default: 1> }. A warning
+/// is displayed for each setting that cannot be applied.
+/// @param thread The thread to configure.
+/// @param config Configuration of the thread.
+/// @param observerName Name of the observer, used for the warnings.
+/// @return False if one of the settings could not be applied.
+bool configureThread(std::thread & thread, const mc_rtc::Configuration & config, const std::string & observerName);
+
+/// @brief Fixed-size pool of worker threads executing indexed tasks.
+class WorkerPool
+{
+public:
+  /// @param nbThreads Number of worker threads, in addition to the thread calling parallelFor.
+  /// @param cpus Cpus on which the worker threads are pinned (no pinning if empty).
+  WorkerPool(size_t nbThreads, const std::vector<int> & cpus = {});
+
+  /// @brief Stops and joins the worker threads.
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool &) = delete;
+  WorkerPool & operator=(const WorkerPool &) = delete;
+
+  /// @brief Executes task(i) for every i in [0, nbTasks) on the workers and on the calling thread, and returns once
+  /// all of them are done. The order in which the tasks are executed is not defined.
+  /// @param nbTasks Number of tasks to execute.
+  /// @param task Function executing the task of the given index. Must not throw.
+  void parallelFor(size_t nbTasks, const std::function<void(size_t)> & task);
+
+  inline size_t nbThreads() const noexcept { return threads_.size(); }
+
+private:
+  void workerLoop();
+  // executes the pending tasks of the current batch
+  void work();
+
+  std::vector<std::thread> threads_;
+
+  std::mutex mutex_;
+  std::condition_variable startCondition_;
+  std::condition_variable doneCondition_;
+  bool stop_ = false;
+  // incremented on each new batch of tasks
+  size_t generation_ = 0;
+  // number of workers currently executing work()
+  size_t activeWorkers_ = 0;
+
+  const std::function<void(size_t)> * task_ = nullptr;
+  size_t nbTasks_ = 0;
+  std::atomic<size_t> nextTask_{0};
+  std::atomic<size_t> remainingTasks_{0};
+};
+
+/// @brief Lock-free slot passing the latest value written by one producer thread to one consumer thread.
+/// @details Triple buffering: the producer and the consumer each own one of the three buffers and swap it with the
+/// third one through an atomic index, so neither of them ever waits, copies the other's buffer or allocates memory.
+/// Values published faster than they are consumed are overwritten, only the latest one is kept.
+template<typename T>
+class LatestValueSlot
+{
+public:
+  /// @brief Buffer to fill by the producer before calling publish(). Must only be used by the producer.
+  inline T & back() noexcept { return buffers_[back_]; }
+
+  /// @brief Makes the back buffer the latest value. Must only be called by the producer.
+  inline void publish() noexcept
+  {
+    back_ = middle_.exchange(back_ | newValueBit, std::memory_order_acq_rel) & indexMask;
+  }
+
+  /// @brief Copies the value into the back buffer and publishes it. Must only be called by the producer.
+  inline void publish(const T & value)
+  {
+    back() = value;
+    publish();
+  }
+
+  /// @brief Retrieves the latest published value, if a new one is available. Must only be called by the consumer.
+  /// @return True if a value was published since the last call, it can then be read with front().
+  inline bool consume() noexcept
+  {
+    if((middle_.load(std::memory_order_acquire) & newValueBit) == 0) { return false; }
+    front_ = middle_.exchange(front_, std::memory_order_acq_rel) & indexMask;
+    return true;
+  }
+
+  /// @brief Latest value retrieved by consume(). Must only be used by the consumer.
+  inline const T & front() const noexcept { return buffers_[front_]; }
+
+private:
+  static constexpr unsigned int indexMask = 3;
+  static constexpr unsigned int newValueBit = 4;
+
+  std::array<T, 3> buffers_;
+  // buffer owned by the producer
+  unsigned int back_ = 0;
+  // buffer owned by the consumer
+  unsigned int front_ = 1;
+  // buffer exchanged between them, with a flag indicating if it contains a value not consumed yet
+  alignas(64) std::atomic<unsigned int> middle_{2};
+};
+
+} // namespace threadingTools
+} // namespace mc_state_observation
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <mc_rtc/Configuration.h>
+#include <mc_rtc/gui/StateBuilder.h>
+#include <mc_rtc/log/Logger.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+/**
+ * Tools to measure the computation time of the observers.
+ * An ExecutionTimer holds a set of named stages (typically "run" and "update", plus optional sub-stages of the
+ * estimation). Each stage stores its last durations in a ring buffer allocated once at registration so that timing a
+ * stage in the control loop only costs two reads of the monotonic clock and a write in the buffer. The rolling
+ * statistics (min / mean / p99 / max) are computed on demand by the GUI.
+ * A DeadlineMonitor compares the duration of each iteration to a time budget and tells the observer when to switch to
+ * a cheaper estimation and when to come back to the nominal one.
+ **/
+
+namespace mc_state_observation
+{
+namespace timingTools
+{
+
+/// @brief Measures the duration of named stages of an observer with a monotonic clock.
+class ExecutionTimer
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  /// @brief Rolling statistics of a stage, in milliseconds.
+  struct Statistics
+  {
+    double last = 0.0;
+    double min = 0.0;
+    double mean = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+  };
+
+  /// @brief Scoped measurement of a stage: starts the timer on construction and stops it on destruction.
+  class Scope
+  {
+  public:
+    Scope(ExecutionTimer & timer, size_t stage) : timer_(timer), stage_(stage) { timer_.start(stage_); }
+    ~Scope() { timer_.stop(stage_); }
+
+    Scope(const Scope &) = delete;
+    Scope & operator=(const Scope &) = delete;
+
+  private:
+    ExecutionTimer & timer_;
+    size_t stage_;
+  };
+
+public:
+  /// @param windowSize Number of samples used for the rolling statistics of each stage.
+  explicit ExecutionTimer(size_t windowSize = 1000) : windowSize_(windowSize) {}
+
+  /// @brief Registers a new stage and allocates its buffer. Must not be called from the control loop.
+  /// @param name Name of the stage, used for the log entries and the GUI.
+  /// @return The index of the stage, to be given to start(), stop() and scope().
+  size_t addStage(const std::string & name);
+
+  /// @brief Enables or disables the measurements. When disabled, start() and stop() do nothing and no log entry or
+  /// GUI element is added.
+  inline void enabled(bool enabled) { enabled_ = enabled; }
+  inline bool enabled() const noexcept { return enabled_; }
+
+  inline void start(size_t stage)
+  {
+    if(!enabled_) { return; }
+    stages_[stage].start = Clock::now();
+  }
+
+  inline void stop(size_t stage)
+  {
+    if(!enabled_) { return; }
+    Stage & s = stages_[stage];
+    s.last = std::chrono::duration<double, std::milli>(Clock::now() - s.start).count();
+    s.samples[s.next] = s.last;
+    s.next = (s.next + 1 == windowSize_) ? 0 : s.next + 1;
+    if(s.count < windowSize_) { ++s.count; }
+  }
+
+  /// @brief Returns a Scope object measuring the given stage until it goes out of scope.
+  inline Scope scope(size_t stage) { return Scope(*this, stage); }
+
+  /// @brief Returns the duration of the last measurement of the stage, in milliseconds.
+  inline double last(size_t stage) const { return stages_[stage].last; }
+
+  /// @brief Computes the rolling statistics of the stage over the last windowSize samples.
+  Statistics statistics(size_t stage) const;
+
+  /// @brief Clears the samples of all the stages.
+  void reset();
+
+  void addToLogger(mc_rtc::Logger & logger, const std::string & prefix);
+  void removeFromLogger(mc_rtc::Logger & logger, const std::string & prefix);
+  void addToGUI(mc_rtc::gui::StateBuilder & gui, const std::vector<std::string> & category);
+  void removeFromGUI(mc_rtc::gui::StateBuilder & gui, const std::vector<std::string> & category);
+
+private:
+  struct Stage
+  {
+    std::string name;
+    std::vector<double> samples; // ring buffer containing the last durations
+    size_t next = 0; // index of the next sample to write
+    size_t count = 0; // number of valid samples
+    double last = 0.0;
+    Clock::time_point start;
+  };
+
+  size_t windowSize_;
+  bool enabled_ = false;
+  std::vector<Stage> stages_;
+  // buffer used to compute the percentile without modifying the samples
+  mutable std::vector<double> sortedSamples_;
+};
+
+/// @brief Switches an observer to a degraded mode when its iterations exceed a time budget.
+/// @details The observer enters the degraded mode after overrunIterations consecutive iterations exceeding the budget,
+/// and goes back to the nominal mode after recoveryIterations consecutive iterations within the budget. As the
+/// degraded iterations are cheaper, the recovery is delayed so that the mode does not switch at every iteration.
+class DeadlineMonitor
+{
+public:
+  using Clock = ExecutionTimer::Clock;
+
+  /// @brief Scoped measurement of an iteration: starts the monitor on construction and stops it on destruction.
+  class Scope
+  {
+  public:
+    explicit Scope(DeadlineMonitor & monitor) : monitor_(monitor) { monitor_.start(); }
+    ~Scope() { monitor_.stop(); }
+
+    Scope(const Scope &) = delete;
+    Scope & operator=(const Scope &) = delete;
+
+  private:
+    DeadlineMonitor & monitor_;
+  };
+
+public:
+  /// @brief Reads the configuration of the monitor.
+  /// @details Expected configuration: { budget: <time budget of an iteration in ms, disabled if 0>,
+  /// overrunIterations: <default 3>, recoveryIterations: <default 500> }.
+  /// @param config Configuration of the monitor.
+  /// @param observerName Name of the observer, used for the messages on the mode changes.
+  void configure(const mc_rtc::Configuration & config, const std::string & observerName);
+
+  /// @brief The monitor is enabled if a positive budget is given.
+  inline bool enabled() const noexcept { return budget_ > 0.0; }
+
+  inline void start()
+  {
+    if(!enabled()) { return; }
+    start_ = Clock::now();
+  }
+
+  /// @brief Measures the iteration started with start() and updates the mode.
+  void stop();
+
+  /// @brief Returns a Scope object measuring the iteration until it goes out of scope.
+  inline Scope scope() { return Scope(*this); }
+
+  /// @brief True if the observer must use its degraded mode on the next iteration.
+  inline bool degraded() const noexcept { return degraded_; }
+
+  /// @brief Duration of the last iteration, in milliseconds.
+  inline double last() const noexcept { return last_; }
+
+  /// @brief Number of times the degraded mode was entered.
+  inline size_t nbDegradations() const noexcept { return nbDegradations_; }
+
+  /// @brief Goes back to the nominal mode.
+  void reset();
+
+  void addToLogger(mc_rtc::Logger & logger, const std::string & prefix);
+  void removeFromLogger(mc_rtc::Logger & logger, const std::string & prefix);
+
+private:
+  std::string observerName_;
+  double budget_ = 0.0; // time budget of an iteration (ms)
+  unsigned int overrunIterations_ = 3;
+  unsigned int recoveryIterations_ = 500;
+
+  Clock::time_point start_;
+  double last_ = 0.0;
+  bool degraded_ = false;
+  // number of consecutive iterations exceeding (nominal mode) or within (degraded mode) the budget
+  unsigned int count_ = 0;
+  size_t nbDegradations_ = 0;
+};
+
+} // namespace timingTools
+} // namespace mc_state_observation
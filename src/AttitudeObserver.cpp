@@ -22,10 +22,15 @@ AttitudeObserver::AttitudeObserver(const std::string & type, double dt)
   /// initialization of the extended Kalman filter
   imuFunctor_.setSamplingPeriod(dt_);
   filter_.setFunctor(&imuFunctor_);
+  /// derivation step for the finite difference method
+  dx_ = filter_.stateVectorConstant(1) * 1e-8;
   Kpt_ << -20, 0, 0, 0, -20, 0, 0, 0, -20;
   Kdt_ << -10, 0, 0, 0, -10, 0, 0, 0, -10;
   Kpo_ << -0.0, 0, 0, 0, -0.0, 0, 0, 0, -10;
   Kdo_ << -0.0, 0, 0, 0, -0.0, 0, 0, 0, -10;
+
+  runTiming_ = timer_.addStage("run");
+  updateTiming_ = timer_.addStage("update");
 }
 
 void AttitudeObserver::configure(const mc_control::MCController & ctl, const mc_rtc::Configuration & config)
@@ -35,8 +40,22 @@ void AttitudeObserver::configure(const mc_control::MCController & ctl, const mc_
   if(config.has("updateSensor")) { updateSensor_ = static_cast<std::string>(config("updateSensor")); }
   else { updateSensor_ = imuSensor_; }
   datastoreName_ = config("datastoreName", name());
+  accRefKey_ = datastoreName_ + "::accRef";
+  // the sensors are resolved once, the control loop then accesses them by index
+  const auto & robot = ctl.robot(robot_);
+  for(const auto & sensorName : {imuSensor_, updateSensor_})
+  {
+    if(!robot.hasBodySensor(sensorName))
+    {
+      mc_rtc::log::error_and_throw<std::runtime_error>("[{}] Robot {} has no body sensor named {}", name(), robot_,
+                                                       sensorName);
+    }
+  }
+  imuSensorIndex_ = robot.data()->bodySensorsIndex.at(imuSensor_);
+  updateSensorIndex_ = robot.data()->bodySensorsIndex.at(updateSensor_);
   config("log_kf", log_kf_);
   config("init_from_control", initFromControl_);
+  timer_.enabled(config("withTimings", false));
   defaultConfig_ = config("KalmanFilter", KalmanFilterConfig{});
   config_ = defaultConfig_;
   desc_ = fmt::format("{} (sensor={})", name_, imuSensor_);
@@ -74,6 +93,7 @@ void AttitudeObserver::reset(const mc_control::MCController & ctl)
 
 bool AttitudeObserver::run(const mc_control::MCController & ctl)
 {
+  auto runTimer = timer_.scope(runTiming_);
   const auto & c = config_;
   bool ret = true;
 
@@ -93,7 +113,7 @@ bool AttitudeObserver::run(const mc_control::MCController & ctl)
   }
 
   // Get sensor values
-  const mc_rbdyn::BodySensor & imu = ctl.robot(robot_).bodySensor(imuSensor_);
+  const mc_rbdyn::BodySensor & imu = ctl.robot(robot_).data()->bodySensors[imuSensorIndex_];
   const Eigen::Vector3d & accIn = imu.linearAcceleration();
   const Eigen::Vector3d & rateIn = imu.angularVelocity();
 
@@ -101,9 +121,9 @@ bool AttitudeObserver::run(const mc_control::MCController & ctl)
   so::Vector6 measurement;
   if(c.compensateMode)
   {
-    if(ctl.datastore().has(datastoreName_ + "::accRef"))
+    if(ctl.datastore().has(accRefKey_))
     {
-      const Eigen::Vector3d & accRef = ctl.datastore().get<Eigen::Vector3d>(datastoreName_ + "::accRef");
+      const Eigen::Vector3d & accRef = ctl.datastore().get<Eigen::Vector3d>(accRefKey_);
       measurement.head<3>() = accIn - accRef;
     }
     else
@@ -124,11 +144,8 @@ bool AttitudeObserver::run(const mc_control::MCController & ctl)
   filter_.setInput(uk_, time);
   filter_.setMeasurement(measurement, time + 1);
 
-  /// set the derivation step for the finite difference method
-  const so::Vector dx = filter_.stateVectorConstant(1) * 1e-8;
-
-  filter_.setA(filter_.getAMatrixFD(dx));
-  filter_.setC(filter_.getCMatrixFD(dx));
+  filter_.setA(filter_.getAMatrixFD(dx_));
+  filter_.setC(filter_.getCMatrixFD(dx_));
 
   /// get the estimation and give it to the array
   xk_ = filter_.getEstimatedState(time + 1);
@@ -142,11 +159,10 @@ bool AttitudeObserver::run(const mc_control::MCController & ctl)
 
 void AttitudeObserver::update(mc_control::MCController & ctl)
 {
+  auto updateTimer = timer_.scope(updateTiming_);
   auto & robot = ctl.robot(robot_);
   auto & data = *robot.data();
-  auto & sensor = data.bodySensors.at(data.bodySensorsIndex.at(updateSensor_));
-  Eigen::Quaterniond quat(m_orientation.transpose());
-  sensor.orientation(quat);
+  data.bodySensors[updateSensorIndex_].orientation(Eigen::Quaterniond(m_orientation.transpose()));
 }
 
 void AttitudeObserver::addToLogger(const mc_control::MCController &,
@@ -158,12 +174,14 @@ void AttitudeObserver::addToLogger(const mc_control::MCController &,
                        return sva::PTransformd{m_orientation.transpose(), Eigen::Vector3d::Zero()};
                      });
   if(log_kf_) { config_.addToLogger(logger, category); }
+  timer_.addToLogger(logger, category);
 }
 
 void AttitudeObserver::removeFromLogger(mc_rtc::Logger & logger, const std::string & category)
 {
   logger.removeLogEntry(category + "_orientation");
   if(log_kf_) { config_.removeFromLogger(logger, category); }
+  timer_.removeFromLogger(logger, category);
 }
 
 void AttitudeObserver::addToGUI(const mc_control::MCController & ctl,
@@ -186,6 +204,7 @@ void AttitudeObserver::addToGUI(const mc_control::MCController & ctl,
                                            return mc_rbdyn::rpyFromMat(m_orientation.transpose()) * 180.
                                                   / mc_rtc::constants::PI;
                                          }));
+  timer_.addToGUI(gui, category);
 }
 
 void AttitudeObserver::KalmanFilterConfig::addToLogger(mc_rtc::Logger & logger, const std::string & category)
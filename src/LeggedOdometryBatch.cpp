@@ -0,0 +1,226 @@
+/**
+ * Offline legged odometry over a batch of recordings.
+ * Each capture of the inputs of an observer (see the "capture" configuration of the MCKineticsObserver and of the
+ * TiltObserver) is replayed through its own leggedOdometry::LeggedOdometryCore, without controller. The captures are
+ * processed in parallel, one per thread, and the estimated trajectory of the floating base of each of them is written
+ * to a CSV file, for example to analyze the drift of the odometry over many recorded walks.
+ * The tilt given to the odometry is the orientation of the floating base of the captured real robot, as done by the
+ * LeggedOdometryManager when the tilt is not given by the observer.
+ *
+ * Usage: mc_state_observation_lo_batch <batch configuration>
+ **/
+
+#include <mc_rbdyn/RobotLoader.h>
+#include <mc_rbdyn/Robots.h>
+#include <mc_rtc/Configuration.h>
+#include <mc_rtc/logging.h>
+#include <mc_state_observation/observersTools/captureTools.h>
+#include <mc_state_observation/observersTools/leggedOdometryTools.h>
+#include <mc_state_observation/observersTools/threadingTools.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mc_state_observation;
+namespace so = stateObservation;
+
+namespace
+{
+
+constexpr char batchName[] = "LeggedOdometryBatch";
+
+using ContactsDetection = leggedOdometry::LeggedOdometryCore::ContactsManager::ContactsDetection;
+
+class Batch
+{
+public:
+  explicit Batch(const mc_rtc::Configuration & config);
+
+  /// @brief Processes all the captures.
+  /// @return The number of captures that could not be processed.
+  size_t run();
+
+private:
+  /// @brief Replays the capture through a new odometry and writes the estimated trajectory.
+  void process(const std::string & capture) const;
+
+  /// @brief Path of the trajectory estimated from the given capture.
+  std::string outputPath(const std::string & capture) const;
+
+private:
+  std::shared_ptr<mc_rbdyn::RobotModule> robotModule_;
+  // the loading of the robots is not thread-safe
+  mutable std::mutex robotsMutex_;
+
+  std::vector<std::string> captures_;
+  std::string output_;
+
+  measurements::OdometryType odometryType_ = measurements::odometry6d;
+  bool withYawEstimation_ = true;
+  ContactsDetection contactsDetection_ = ContactsDetection::fromThreshold;
+  std::vector<std::string> surfacesForContactDetection_;
+  std::vector<std::string> forceSensorsToOmit_;
+  double contactDetectionPropThreshold_ = 0.11;
+  // time step of the first frame, the next ones are given by the captured controller time
+  double dt_ = 0.005;
+
+  std::unique_ptr<threadingTools::WorkerPool> pool_;
+};
+
+Batch::Batch(const mc_rtc::Configuration & config)
+{
+  std::vector<std::string> robotModule;
+  if(config("robot").isArray()) { robotModule = config("robot"); }
+  else { robotModule = {static_cast<std::string>(config("robot"))}; }
+  robotModule_ = mc_rbdyn::RobotLoader::get_robot_module(robotModule);
+
+  captures_ = config("captures", std::vector<std::string>{});
+  if(captures_.empty())
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[{}] No capture to process", batchName);
+  }
+  output_ = static_cast<std::string>(config("output"));
+
+  const std::string odometryType = config("odometryType", std::string("6dOdometry"));
+  if(odometryType == "flatOdometry") { odometryType_ = measurements::flatOdometry; }
+  else if(odometryType == "6dOdometry") { odometryType_ = measurements::odometry6d; }
+  else
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>(
+        "[{}] Odometry type {} not allowed. Please pick among : [flatOdometry, 6dOdometry]", batchName, odometryType);
+  }
+  config("withYawEstimation", withYawEstimation_);
+
+  // the contacts given by the solver are not captured
+  const std::string contactsDetection = config("contactsDetection", std::string("fromThreshold"));
+  if(contactsDetection == "fromThreshold") { contactsDetection_ = ContactsDetection::fromThreshold; }
+  else if(contactsDetection == "fromSurfaces") { contactsDetection_ = ContactsDetection::fromSurfaces; }
+  else
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>(
+        "[{}] Contacts detection type {} not allowed. Please pick among : [fromThreshold, fromSurfaces]", batchName,
+        contactsDetection);
+  }
+  config("surfacesForContactDetection", surfacesForContactDetection_);
+  config("forceSensorsToOmit", forceSensorsToOmit_);
+  config("contactDetectionPropThreshold", contactDetectionPropThreshold_);
+  config("dt", dt_);
+
+  const size_t nbThreads = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+  pool_.reset(new threadingTools::WorkerPool(config("threads", nbThreads), config("cpus", std::vector<int>{})));
+}
+
+size_t Batch::run()
+{
+  std::atomic<size_t> nbFailed{0};
+  pool_->parallelFor(captures_.size(),
+                     [&](size_t i)
+                     {
+                       try
+                       {
+                         process(captures_[i]);
+                         mc_rtc::log::info("[{}] {} processed, trajectory written to {}", batchName, captures_[i],
+                                           outputPath(captures_[i]));
+                       }
+                       catch(const std::exception & e)
+                       {
+                         mc_rtc::log::warning("[{}] The processing of {} failed: {}", batchName, captures_[i],
+                                              e.what());
+                         nbFailed++;
+                       }
+                     });
+  return nbFailed;
+}
+
+void Batch::process(const std::string & capture) const
+{
+  const std::vector<double> times = captureTools::readFramesTime(capture);
+  captureTools::InputsCapture inputs;
+  mc_rtc::Configuration captureConfig;
+  captureConfig.add("mode", std::string("replay"));
+  captureConfig.add("path", capture);
+
+  mc_rbdyn::RobotsPtr robots;
+  {
+    std::lock_guard<std::mutex> lock(robotsMutex_);
+    robots = mc_rbdyn::loadRobot(*robotModule_);
+    // the capture also loads the robots into which the inputs are replayed
+    inputs.configure(captureConfig, batchName, robots->robot());
+  }
+  // the force measurements are read from the control robot, the joints and the floating base from the real robot
+  const auto & robot = inputs.robot(robots->robot());
+  const auto & realRobot = inputs.realRobot(robots->robot());
+
+  std::ofstream out(outputPath(capture));
+  if(!out) { mc_rtc::log::error_and_throw<std::runtime_error>("Could not create {}", outputPath(capture)); }
+  out << "time,x,y,z,qw,qx,qy,qz,nbContacts\n";
+
+  leggedOdometry::LeggedOdometryCore odometry;
+  for(size_t i = 0; i < times.size() && inputs.process(times[i], robot, realRobot); i++)
+  {
+    if(i == 0)
+    {
+      // the odometry starts from the captured pose of the floating base
+      odometry.init(realRobot, batchName, odometryType_, withYawEstimation_, false, false, false);
+      const double contactDetectionThreshold =
+          robot.mass() * so::cst::gravityConstant * contactDetectionPropThreshold_;
+      const std::vector<std::string> contactsSensorDisabledInit;
+      if(contactsDetection_ == ContactsDetection::fromSurfaces)
+      {
+        odometry.initDetection(robot, contactsDetection_, surfacesForContactDetection_, contactsSensorDisabledInit,
+                               contactDetectionThreshold);
+      }
+      else
+      {
+        odometry.initDetection(robot, contactsDetection_, contactsSensorDisabledInit, contactDetectionThreshold,
+                               forceSensorsToOmit_);
+      }
+    }
+
+    const double dt = (i == 0) ? dt_ : times[i] - times[i - 1];
+    const so::Matrix3 tilt = realRobot.posW().rotation().transpose();
+    odometry.run(robot, realRobot, dt, tilt, true, false);
+
+    const sva::PTransformd & pose = odometry.odometryRobot().posW();
+    const Eigen::Quaterniond ori(pose.rotation().transpose());
+    out << times[i] << ',' << pose.translation().x() << ',' << pose.translation().y() << ','
+        << pose.translation().z() << ',' << ori.w() << ',' << ori.x() << ',' << ori.y() << ',' << ori.z() << ','
+        << odometry.contactsManager().contactsFound().size() << '\n';
+  }
+}
+
+std::string Batch::outputPath(const std::string & capture) const
+{
+  std::string stem = capture.substr(capture.find_last_of('/') + 1);
+  stem = stem.substr(0, stem.find_last_of('.'));
+  return output_ + "/" + stem + ".csv";
+}
+
+} // namespace
+
+int main(int argc, char * argv[])
+{
+  if(argc != 2)
+  {
+    std::fprintf(stderr, "Usage: %s <batch configuration>\n", argv[0]);
+    return 1;
+  }
+
+  try
+  {
+    Batch batch(mc_rtc::Configuration(argv[1]));
+    return batch.run() == 0 ? 0 : 1;
+  }
+  catch(const std::exception & e)
+  {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+}
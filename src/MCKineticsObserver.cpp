@@ -25,6 +25,20 @@ MCKineticsObserver::MCKineticsObserver(const std::string & type, double dt)
 : mc_observers::Observer(type, dt), observer_(4, 2)
 {
   observer_.setSamplingTime(dt);
+
+  runTiming_ = timer_.addStage("run");
+  contactsTiming_ = timer_.addStage("updateContacts");
+  imusTiming_ = timer_.addStage("updateIMUs");
+  estimatorTiming_ = timer_.addStage("estimatorUpdate");
+  updateTiming_ = timer_.addStage("update");
+}
+
+MCKineticsObserver::~MCKineticsObserver()
+{
+  if(datastore_ != nullptr && datastore_->has(observerName_ + "::setAbsolutePose"))
+  {
+    datastore_->remove(observerName_ + "::setAbsolutePose");
+  }
 }
 
 ///////////////////////////////////////////////////////////////////////
@@ -53,6 +67,16 @@ void MCKineticsObserver::configure(const mc_control::MCController & ctl, const m
   }
 
   config("withDebugLogs", withDebugLogs_);
+  timer_.enabled(config("withTimings", false));
+  displayRobot_.configure(config("guiRate", 30.), ctl.timeStep);
+  if(config.has("capture")) { inputsCapture_.configure(config("capture"), observerName_, robot); }
+  if(config.has("deadline"))
+  {
+    deadline_.configure(config("deadline"), observerName_);
+    const std::vector<std::string> degradableContacts =
+        config("deadline")("degradableContacts", std::vector<std::string>());
+    degradableContacts_ = std::set<std::string>(degradableContacts.begin(), degradableContacts.end());
+  }
 
   config("withFilteredForcesContactDetection", withFilteredForcesContactDetection_);
 
@@ -231,6 +255,17 @@ void MCKineticsObserver::configure(const mc_control::MCController & ctl, const m
 
   invincibilityFrame_ = int(1.5 / ctl.timeStep);
 
+  /* Absolute pose measurements */
+
+  config("absolutePoseMaxDelay", absolutePoseMaxDelay_);
+  // replaces the call of a previous instance of the observer, which captured another object
+  if(datastore.has(observerName_ + "::setAbsolutePose")) { datastore.remove(observerName_ + "::setAbsolutePose"); }
+  datastore.make_call(observerName_ + "::setAbsolutePose",
+                      [this](const sva::PTransformd & X_0_fb, double time, bool withPosition)
+                      { setAbsolutePose(X_0_fb, time, withPosition); });
+  datastore_ = &datastore;
+
+  ctl.gui()->removeElement({observerName_}, "SimulateNanBehaviour");
   ctl.gui()->addElement({observerName_},
                         mc_rtc::gui::Button("SimulateNanBehaviour", [this]() { observer_.nanDetected_ = true; }));
 }
@@ -308,17 +343,17 @@ void MCKineticsObserver::reset(const mc_control::MCController & ctl)
   invincibilityIter_ = 0;
 
   my_robots_ = mc_rbdyn::Robots::make();
-  my_robots_->robotCopy(robot, robot.name());
   my_robots_->robotCopy(realRobot, "inputRobot");
-  ctl.gui()->addElement(
-      {"Robots"},
-      mc_rtc::gui::Robot(observerName_, [this]() -> const mc_rbdyn::Robot & { return my_robots_->robot(); }));
+  displayRobot_.reset(*ctl.gui(), {"Robots"}, observerName_, robot);
+  ctl.gui()->removeElement({"Robots"}, "Real");
   ctl.gui()->addElement({"Robots"},
                         mc_rtc::gui::Robot("Real", [&ctl]() -> const mc_rbdyn::Robot & { return ctl.realRobot(); }));
 
   X_0_fb_ = robot.posW().translation();
 
   initObserverStateVector(realRobot);
+  deadline_.reset();
+  absolutePose_ = AbsolutePoseMeasurement();
 }
 
 void MCKineticsObserver::addSensorsAsInputs(const mc_rbdyn::Robot & inputRobot,
@@ -338,11 +373,22 @@ void MCKineticsObserver::addSensorsAsInputs(const mc_rbdyn::Robot & inputRobot,
 
 bool MCKineticsObserver::run(const mc_control::MCController & ctl)
 {
-  const auto & robot = ctl.robot(robot_);
-  const auto & realRobot = ctl.realRobot(robot_);
-  auto & inputRobot = my_robots_->robot("inputRobot");
+  auto runTimer = timer_.scope(runTiming_);
+  // the mode used in this iteration is decided from the duration of the previous ones
+  auto deadlineScope = deadline_.scope();
   auto & logger = (const_cast<mc_control::MCController &>(ctl)).logger();
 
+  // records the inputs of the iteration, or replays the captured ones into the robots of the capture
+  if(!inputsCapture_.process(logger.t(), ctl.robot(robot_), ctl.realRobot(robot_)))
+  {
+    error_ = fmt::format("[{}] End of the replayed capture", observerName_);
+    return false;
+  }
+
+  const auto & robot = inputsCapture_.robot(ctl.robot(robot_));
+  const auto & realRobot = inputsCapture_.realRobot(ctl.realRobot(robot_));
+  auto & inputRobot = my_robots_->robot("inputRobot");
+
   inputRobot.mbc() = realRobot.mbc();
   inputRobot.mb() = realRobot.mb();
 
@@ -366,20 +412,39 @@ bool MCKineticsObserver::run(const mc_control::MCController & ctl)
    * force sensor and not the contact surface!
    */
   // retrieves the list of contacts and set simStarted to true once a contact is detected
+  timer_.start(contactsTiming_);
   updateContacts(ctl, findNewContacts(ctl), logger);
+  inputsCapture_.contacts(contactsManager_.contactsFound());
 
   // force measurements from sensor that are not associated to a currently set contact are given to the Kinetics
   // Observer as inputs.
   inputAdditionalWrench(inputRobot, robot);
+  timer_.stop(contactsTiming_);
 
   /** Accelerometers **/
+  timer_.start(imusTiming_);
   updateIMUs(robot, inputRobot);
+  timer_.stop(imusTiming_);
 
-  /*
-  so::kine::Orientation oriMeasurement;
-  //oriMeasurement = so::Matrix3(realRobot.posW().rotation().transpose());
-  observer_.setAbsoluteOriSensor(oriMeasurement);
-  */
+  /** Absolute pose **/
+  // the measurements are sparse, the Kinetics Observer is only corrected with them on the iterations receiving one
+  if(absolutePoseInput_.consume())
+  {
+    const auto & measurement = absolutePoseInput_.front();
+    absolutePoseDelay_ = logger.t() - measurement.time;
+    if(absolutePoseDelay_ <= absolutePoseMaxDelay_ && measurement.time >= absolutePose_.time)
+    {
+      absolutePose_ = measurement;
+      so::kine::Kinematics worldFbKine;
+      worldFbKine.orientation = so::Matrix3(measurement.X_0_fb.rotation().transpose());
+      if(measurement.withPosition)
+      {
+        worldFbKine.position = measurement.X_0_fb.translation();
+        observer_.setAbsolutePoseSensor(worldFbKine);
+      }
+      else { observer_.setAbsoluteOriSensor(worldFbKine.orientation); }
+    }
+  }
 
   /** Inertias **/
   /** TODO : Merge inertias into CoM inertia and/or get it from fd() **/
@@ -391,7 +456,9 @@ bool MCKineticsObserver::run(const mc_control::MCController & ctl)
       inertiaWaist_.inertia() + observer_.getMass() * so::kine::skewSymmetric2(observer_.getCenterOfMass()())));
   /* Step once, and return result */
 
+  timer_.start(estimatorTiming_);
   res_ = observer_.update();
+  timer_.stop(estimatorTiming_);
 
   // Kinematics of the floating base in the real world frame (our estimation goal)
   so::kine::Kinematics mcko_K_0_fb;
@@ -476,7 +543,7 @@ bool MCKineticsObserver::run(const mc_control::MCController & ctl)
           const mc_rbdyn::ForceSensor & forceSensor = robot.forceSensor(contact.forceSensorName());
 
           // the tilt of the robot changed so the contribution of the gravity to the measurements changed too
-          if(KoContactsManager().getContactsDetection() == KoContactsManager::ContactsDetection::fromThreshold)
+          if(contactsManager_.getContactsDetection() == KoContactsManager::ContactsDetection::fromThreshold)
           {
             updateContactForceMeasurement(contact, forceSensor.wrenchWithoutGravity(inputRobot));
           }
@@ -552,17 +619,25 @@ bool MCKineticsObserver::run(const mc_control::MCController & ctl)
         KoContactWithSensor contact = contactsManager_.contactWithSensor(contactIndex);
 
         // Update of the force measurements (the offset due to the gravity changed)
-        const mc_rbdyn::ForceSensor & forceSensor = inputRobot.forceSensor(contact.forceSensorName());
+        const mc_rbdyn::ForceSensor & forceSensor = robot.forceSensor(contact.forceSensorName());
 
-        so::kine::Kinematics bodySensorKine =
-            kinematicsTools::poseFromSva(forceSensor.X_p_f(), so::kine::Kinematics::Flags::vel);
+        if(contactsManager_.getContactsDetection() == KoContactsManager::ContactsDetection::fromThreshold)
+        {
+          // the frame of the sensor is the one of the contact
+          updateContactForceMeasurement(contact, forceSensor.wrenchWithoutGravity(inputRobot));
+        }
+        else
+        {
+          so::kine::Kinematics bodySensorKine =
+              kinematicsTools::poseFromSva(forceSensor.X_p_f(), so::kine::Kinematics::Flags::vel);
 
-        so::kine::Kinematics bodySurfaceKine = kinematicsTools::poseFromSva(
-            inputRobot.surface(contact.surfaceName()).X_b_s(), so::kine::Kinematics::Flags::vel);
+          so::kine::Kinematics bodySurfaceKine = kinematicsTools::poseFromSva(
+              inputRobot.surface(contact.surfaceName()).X_b_s(), so::kine::Kinematics::Flags::vel);
 
-        so::kine::Kinematics surfaceSensorKine = bodySurfaceKine.getInverse() * bodySensorKine;
+          so::kine::Kinematics surfaceSensorKine = bodySurfaceKine.getInverse() * bodySensorKine;
 
-        updateContactForceMeasurement(contact, surfaceSensorKine, forceSensor.wrenchWithoutGravity(inputRobot));
+          updateContactForceMeasurement(contact, surfaceSensorKine, forceSensor.wrenchWithoutGravity(inputRobot));
+        }
 
         so::kine::Kinematics newWorldContactKineRef;
 
@@ -589,10 +664,7 @@ bool MCKineticsObserver::run(const mc_control::MCController & ctl)
   }
 
   /* Update of the visual representation (only a visual feature) of the observed robot */
-  my_robots_->robot().mbc().q = ctl.realRobot().mbc().q;
-
-  /* Update of the observed robot */
-  update(my_robots_->robot());
+  displayRobot_.update(ctl.realRobot(), [this](mc_rbdyn::Robot & displayed) { update(displayed); });
 
   return true;
 } // namespace mc_state_observation
@@ -618,6 +690,7 @@ void MCKineticsObserver::initObserverStateVector(const mc_rbdyn::Robot & robot)
 void MCKineticsObserver::update(mc_control::MCController & ctl) // this function is called by the pipeline if the
                                                                 // update is set to true in the configuration file
 {
+  auto updateTimer = timer_.scope(updateTiming_);
   auto & datastore = (const_cast<mc_control::MCController &>(ctl)).datastore();
   // this function checks that the backup estimator uses the same odometry type than the Kinetics Observer
   datastore.call<>("checkCorrectBackupConf", odometryType_);
@@ -706,7 +779,13 @@ void MCKineticsObserver::updateIMUs(const mc_rbdyn::Robot & measRobot, const mc_
 const measurements::ContactsManager<KoContactWithSensor, measurements::ContactWithoutSensor>::ContactsSet &
     MCKineticsObserver::findNewContacts(const mc_control::MCController & ctl)
 {
-  contactsManager_.findContacts(ctl, robot_);
+  // the contacts given by the solver are not part of the replayed inputs
+  if(inputsCapture_.mode() == captureTools::InputsCapture::Mode::replay
+     && contactsManager_.getContactsDetection() != KoContactsManager::ContactsDetection::fromSolver)
+  {
+    contactsManager_.findContacts(inputsCapture_.robot(ctl.robot(robot_)));
+  }
+  else { contactsManager_.findContacts(ctl, robot_); }
 
   return contactsManager_.contactsFound(); // list of currently set contacts
 }
@@ -738,7 +817,7 @@ const so::kine::Kinematics MCKineticsObserver::getContactWorldKinematicsAndWrenc
   // kinematics of the frame of the force sensor in the world frame
   so::kine::Kinematics worldSensorKine = worldBodyKine * bodyContactSensorKine;
 
-  if(KoContactsManager().getContactsDetection() == KoContactsManager::ContactsDetection::fromThreshold)
+  if(contactsManager_.getContactsDetection() == KoContactsManager::ContactsDetection::fromThreshold)
   {
     // If the contact is detecting using thresholds, we will then consider the sensor frame as
     // the contact surface frame directly.
@@ -785,7 +864,7 @@ const so::kine::Kinematics MCKineticsObserver::getContactWorldKinematics(KoConta
 
   so::kine::Kinematics worldSensorKine = worldBodyKine * bodyContactSensorKine;
 
-  if(KoContactsManager().getContactsDetection() == KoContactsManager::ContactsDetection::fromThreshold)
+  if(contactsManager_.getContactsDetection() == KoContactsManager::ContactsDetection::fromThreshold)
   {
     // If the contact is detecting using thresholds, we will then consider the sensor frame as
     // the contact surface frame directly.
@@ -828,7 +907,7 @@ void MCKineticsObserver::getOdometryWorldContactRest(const mc_control::MCControl
                                                      KoContactWithSensor & contact,
                                                      so::kine::Kinematics & worldContactKineRef)
 {
-  const auto & robot = ctl.robot(robot_);
+  const auto & robot = inputsCapture_.robot(ctl.robot(robot_));
   if(!contact.sensorEnabled_)
   {
     mc_rtc::log::info("The sensor is disabled but is required for the odometry. It will be used for the odometry "
@@ -885,6 +964,14 @@ void MCKineticsObserver::getOdometryWorldContactRest(const mc_control::MCControl
   }
 }
 
+bool MCKineticsObserver::useContactSensor(const KoContactWithSensor & contact) const
+{
+  if(!contact.sensorEnabled_) { return false; }
+  if(!deadline_.degraded()) { return true; }
+  // in the degraded mode, the measurements of the degradable contacts are dropped to reduce the size of the correction
+  return !degradableContacts_.empty() && degradableContacts_.count(contact.getName()) == 0;
+}
+
 void MCKineticsObserver::updateContact(const mc_control::MCController & ctl,
                                        const int & contactIndex,
                                        mc_rtc::Logger & logger)
@@ -898,7 +985,7 @@ void MCKineticsObserver::updateContact(const mc_control::MCController & ctl,
   */
   auto & inputRobot = my_robots_->robot("inputRobot");
 
-  const auto & robot = ctl.robot(robot_);
+  const auto & robot = inputsCapture_.robot(ctl.robot(robot_));
   KoContactWithSensor & contact = contactsManager_.contactWithSensor(contactIndex);
 
   sva::ForceVecd measuredWrench = robot.forceSensor(contact.forceSensorName()).wrenchWithoutGravity(inputRobot);
@@ -912,28 +999,32 @@ void MCKineticsObserver::updateContact(const mc_control::MCController & ctl,
   {
     // the contact already exists, it is updated
     case true:
-      if(contact.sensorEnabled_) // the force sensor attached to the contact is used in the correction by the
-                                 // Kinetics Observer.
+    {
+      const bool sensorUsed = useContactSensor(contact);
+      if(sensorUsed) // the force sensor attached to the contact is used in the correction by the Kinetics Observer.
       {
         observer_.updateContactWithWrenchSensor(contact.contactWrenchVector_, contactSensorCovariance_,
                                                 contact.fbContactKine_, contactIndex);
       }
       else { observer_.updateContactWithNoSensor(contact.fbContactKine_, contactIndex); }
 
+      // the measurements of the contact are logged only while they are part of the measurement vector (the sensor
+      // can be disabled, or its measurements dropped in the degraded mode), as their index in it is otherwise invalid
       if(withDebugLogs_)
       {
-        if(contact.sensorEnabled_ && !contact.sensorWasEnabled_)
+        if(sensorUsed && !contact.sensorWasEnabled_)
         {
           addContactMeasurementsLogEntries(logger, contactIndex);
           contact.sensorWasEnabled_ = true;
         }
-        if(!contact.sensorEnabled_ && contact.sensorWasEnabled_)
+        if(!sensorUsed && contact.sensorWasEnabled_)
         {
           removeContactMeasurementsLogEntries(logger, contactIndex);
           contact.sensorWasEnabled_ = false;
         }
       }
       break;
+    }
 
     // the contact doesn't exist yet, it is updated
     case false:
@@ -961,8 +1052,8 @@ void MCKineticsObserver::updateContact(const mc_control::MCController & ctl,
         observer_.addContact(worldContactKineRef, contactInitCovarianceFirstContacts_, contactProcessCovariance_,
                              contactIndex, linStiffness_, linDamping_, angStiffness_, angDamping_);
       }
-      if(contact.sensorEnabled_) // checks if the sensor is used in the correction of the Kinetics Observer
-                                 // or not
+      if(useContactSensor(contact)) // checks if the sensor is used in the correction of the Kinetics Observer
+                                    // or not
       {
         // we update the measurements of the sensor and the input kinematics of the contact in the user /
         // floating base's frame
@@ -1418,6 +1509,14 @@ void MCKineticsObserver::addToLogger(const mc_control::MCController & ctl,
     logger.addLogEntry(observerName_ + "_debug_gyroBias_" + imu.name(),
                        [this, imu]() -> Eigen::Vector3d { return mapIMUs_(imu.name()).gyroBias; });
   }
+
+  timer_.addToLogger(logger, category);
+  deadline_.addToLogger(logger, category);
+
+  logger.addLogEntry(category + "_absolutePose_measured",
+                     [this]() -> const sva::PTransformd & { return absolutePose_.X_0_fb; });
+  logger.addLogEntry(category + "_absolutePose_time", [this]() { return absolutePose_.time; });
+  logger.addLogEntry(category + "_absolutePose_delay", [this]() { return absolutePoseDelay_; });
 }
 
 void MCKineticsObserver::removeFromLogger(mc_rtc::Logger & logger, const std::string & category)
@@ -1427,6 +1526,11 @@ void MCKineticsObserver::removeFromLogger(mc_rtc::Logger & logger, const std::st
   logger.removeLogEntry(category + "_mass");
   logger.removeLogEntry(category + "_flexStiffness");
   logger.removeLogEntry(category + "_flexDamping");
+  timer_.removeFromLogger(logger, category);
+  deadline_.removeFromLogger(logger, category);
+  logger.removeLogEntry(category + "_absolutePose_measured");
+  logger.removeLogEntry(category + "_absolutePose_time");
+  logger.removeLogEntry(category + "_absolutePose_delay");
 }
 
 void MCKineticsObserver::changeOdometryType(const mc_control::MCController & ctl, const std::string & newOdometryType)
@@ -1477,6 +1581,7 @@ void MCKineticsObserver::addToGUI(const mc_control::MCController & ctl,
                                                                   }));
   }
   // clang-format on
+  timer_.addToGUI(gui, category);
 }
 
 void MCKineticsObserver::addContactLogEntries(mc_rtc::Logger & logger, const int & contactIndex)
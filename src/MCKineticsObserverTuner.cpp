@@ -0,0 +1,447 @@
+/**
+ * Offline tuning of the covariances of the MCKineticsObserver.
+ * The inputs captured by the observer (see the "capture" configuration of the MCKineticsObserver) are replayed through
+ * many instances of the observer in parallel, each one with a different set of covariances. Each instance runs in its
+ * own controller, created from the given mc_rtc configuration, and the floating base it estimates is compared to a
+ * reference trajectory read from an mc_rtc log (for example the pose given by a MocapObserver during the recording).
+ * The covariances are explored with a grid search (every combination of the candidate values) or a coordinate search
+ * (one parameter at a time, starting from the initial values), and the best ones are written to a YAML file that can
+ * be merged into the configuration of the observer.
+ *
+ * Usage: mc_state_observation_mcko_tuner <tuning configuration>
+ **/
+
+#include <mc_control/mc_global_controller.h>
+#include <mc_rtc/Configuration.h>
+#include <mc_rtc/log/FlatLog.h>
+#include <mc_rtc/logging.h>
+#include <mc_state_observation/observersTools/captureTools.h>
+#include <mc_state_observation/observersTools/threadingTools.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mc_state_observation;
+
+namespace
+{
+
+constexpr char tunerName[] = "MCKineticsObserverTuner";
+
+/// @brief Covariance to tune, with its candidate values.
+struct Parameter
+{
+  std::string name; // name of the covariance in the configuration of the observer
+  std::vector<Eigen::Vector3d> values; // candidate values
+  size_t initial = 0; // index of the value the coordinate search starts from
+};
+
+/// @brief Set of covariances, given by the index of the value of each parameter.
+using Candidate = std::vector<size_t>;
+
+class Tuner
+{
+public:
+  explicit Tuner(const mc_rtc::Configuration & config);
+
+  /// @brief Explores the covariances and writes the best ones to the output file.
+  void run();
+
+private:
+  /// @brief Evaluates every combination of the candidate values.
+  void gridSearch();
+
+  /// @brief Optimizes one parameter at a time, keeping the others to their best value so far, until no parameter can
+  /// be improved.
+  void coordinateSearch();
+
+  /// @brief Evaluates the candidates in parallel. The candidates that were already evaluated are not replayed again.
+  std::vector<double> evaluate(const std::vector<Candidate> & candidates);
+
+  /// @brief Replays the capture with the given covariances.
+  /// @return The score of the estimation (the lower the better), infinite if the replay failed.
+  double score(const Candidate & candidate) const;
+
+  /// @brief Creates and initializes a controller whose observer uses the given covariances.
+  std::unique_ptr<mc_control::MCGlobalController> createController(const Candidate & candidate) const;
+
+  /// @brief Runs the controller over the whole capture and compares the estimated floating base to the reference.
+  double replay(mc_control::MCGlobalController & gc) const;
+
+  /// @brief Reads the reference trajectory and associates each captured frame to its reference pose.
+  void loadReference(const mc_rtc::Configuration & config);
+
+  void keepBest(const std::vector<Candidate> & candidates, const std::vector<double> & scores);
+
+  void writeOutput() const;
+
+private:
+  std::string mcrtcConfig_; // mc_rtc configuration of the replay controllers
+  std::string pipeline_; // pipeline containing the observer, the first one if empty
+  std::string observer_; // name of the observer in the pipeline
+  std::string robot_; // robot whose floating base is estimated, the main robot if empty
+  std::string capture_; // capture replayed by the observer
+  std::string search_ = "grid";
+  std::string output_;
+  double orientationWeight_ = 1.0; // weight of the orientation error (rad) with respect to the position error (m)
+
+  std::vector<Parameter> parameters_;
+
+  std::vector<sva::PTransformd> referencePoses_;
+  // index in referencePoses_ of the reference of each captured frame, -1 if the frame is not scored
+  std::vector<int> referenceIndexes_;
+
+  std::unique_ptr<threadingTools::WorkerPool> pool_;
+  // the loading and unloading of the controllers is not thread-safe
+  mutable std::mutex controllersMutex_;
+
+  std::map<Candidate, double> scores_;
+  Candidate best_;
+  double bestScore_ = std::numeric_limits<double>::infinity();
+};
+
+Tuner::Tuner(const mc_rtc::Configuration & config)
+{
+  mcrtcConfig_ = static_cast<std::string>(config("mc_rtc"));
+  config("pipeline", pipeline_);
+  observer_ = config("observer", std::string("MCKineticsObserver"));
+  config("robot", robot_);
+  capture_ = static_cast<std::string>(config("capture"));
+  config("search", search_);
+  if(search_ != "grid" && search_ != "coordinate")
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>(
+        "[{}] Search {} not allowed. Please pick among : [grid, coordinate]", tunerName, search_);
+  }
+  output_ = static_cast<std::string>(config("output"));
+  config("orientationWeight", orientationWeight_);
+
+  for(const auto & parameterConfig : config("parameters"))
+  {
+    Parameter parameter;
+    parameter.name = static_cast<std::string>(parameterConfig("name"));
+    if(parameterConfig.has("values"))
+    {
+      parameter.values = parameterConfig("values", std::vector<Eigen::Vector3d>{});
+    }
+    else
+    {
+      const Eigen::Vector3d initial = parameterConfig("initial");
+      const std::vector<double> scales = parameterConfig("scales", std::vector<double>{0.1, 1.0, 10.0});
+      for(size_t i = 0; i < scales.size(); i++)
+      {
+        parameter.values.push_back(scales[i] * initial);
+        if(scales[i] == 1.0) { parameter.initial = i; }
+      }
+    }
+    if(parameter.values.empty())
+    {
+      mc_rtc::log::error_and_throw<std::runtime_error>("[{}] The parameter {} has no candidate value", tunerName,
+                                                       parameter.name);
+    }
+    parameters_.push_back(parameter);
+  }
+  if(parameters_.empty())
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[{}] There is no parameter to tune", tunerName);
+  }
+
+  loadReference(config("reference"));
+
+  // the main thread takes part in the evaluations
+  const size_t nbThreads = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+  pool_.reset(new threadingTools::WorkerPool(config("threads", nbThreads), config("cpus", std::vector<int>{})));
+}
+
+void Tuner::loadReference(const mc_rtc::Configuration & config)
+{
+  const std::string logPath = config("log");
+  const std::string entry = config("entry");
+  const double ignoreFirst = config("ignoreFirst", 1.0);
+
+  mc_rtc::log::FlatLog log(logPath);
+  if(!log.has("t") || !log.has(entry))
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[{}] The log {} does not contain the entry {}", tunerName,
+                                                     logPath, entry);
+  }
+  const std::vector<const double *> logTimes = log.getRaw<double>("t");
+  const std::vector<const sva::PTransformd *> logPoses = log.getRaw<sva::PTransformd>(entry);
+
+  std::vector<double> referenceTimes;
+  for(size_t i = 0; i < logTimes.size() && i < logPoses.size(); i++)
+  {
+    if(logTimes[i] == nullptr || logPoses[i] == nullptr) { continue; }
+    referenceTimes.push_back(*logTimes[i]);
+    referencePoses_.push_back(*logPoses[i]);
+  }
+  if(referenceTimes.size() < 2)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[{}] The entry {} of the log {} is empty", tunerName, entry,
+                                                     logPath);
+  }
+  const double tolerance = 0.5 * (referenceTimes[1] - referenceTimes[0]);
+
+  // the frames and the log are timestamped by the logger of the controller that recorded them
+  const std::vector<double> framesTime = captureTools::readFramesTime(capture_);
+  if(framesTime.empty())
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[{}] The capture {} is empty", tunerName, capture_);
+  }
+  size_t nbScored = 0;
+  referenceIndexes_.assign(framesTime.size(), -1);
+  for(size_t k = 0; k < framesTime.size(); k++)
+  {
+    // the estimation converges during the first frames
+    if(framesTime[k] < framesTime.front() + ignoreFirst) { continue; }
+    auto it = std::lower_bound(referenceTimes.begin(), referenceTimes.end(), framesTime[k] - tolerance);
+    if(it == referenceTimes.end() || *it > framesTime[k] + tolerance) { continue; }
+    referenceIndexes_[k] = static_cast<int>(std::distance(referenceTimes.begin(), it));
+    nbScored++;
+  }
+  if(nbScored == 0)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[{}] No captured frame matches the reference trajectory",
+                                                     tunerName);
+  }
+  mc_rtc::log::info("[{}] {} of the {} captured frames are compared to the reference", tunerName, nbScored,
+                    framesTime.size());
+}
+
+void Tuner::run()
+{
+  if(search_ == "grid") { gridSearch(); }
+  else { coordinateSearch(); }
+
+  if(std::isinf(bestScore_))
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[{}] The replay failed for every candidate", tunerName);
+  }
+  writeOutput();
+}
+
+void Tuner::gridSearch()
+{
+  size_t nbCandidates = 1;
+  for(const auto & parameter : parameters_) { nbCandidates *= parameter.values.size(); }
+  mc_rtc::log::info("[{}] Grid search over {} candidates with {} threads", tunerName, nbCandidates,
+                    pool_->nbThreads() + 1);
+
+  std::vector<Candidate> candidates(nbCandidates, Candidate(parameters_.size()));
+  for(size_t i = 0; i < nbCandidates; i++)
+  {
+    size_t index = i;
+    for(size_t j = 0; j < parameters_.size(); j++)
+    {
+      candidates[i][j] = index % parameters_[j].values.size();
+      index /= parameters_[j].values.size();
+    }
+  }
+  keepBest(candidates, evaluate(candidates));
+}
+
+void Tuner::coordinateSearch()
+{
+  mc_rtc::log::info("[{}] Coordinate search with {} threads", tunerName, pool_->nbThreads() + 1);
+
+  Candidate initial;
+  for(const auto & parameter : parameters_) { initial.push_back(parameter.initial); }
+  keepBest({initial}, evaluate({initial}));
+
+  bool improved = true;
+  for(size_t pass = 1; improved; pass++)
+  {
+    improved = false;
+    for(size_t j = 0; j < parameters_.size(); j++)
+    {
+      std::vector<Candidate> candidates;
+      for(size_t v = 0; v < parameters_[j].values.size(); v++)
+      {
+        Candidate candidate = best_;
+        candidate[j] = v;
+        candidates.push_back(candidate);
+      }
+      const double previousScore = bestScore_;
+      keepBest(candidates, evaluate(candidates));
+      improved = improved || bestScore_ < previousScore;
+    }
+    mc_rtc::log::info("[{}] Pass {}: best score {}", tunerName, pass, bestScore_);
+  }
+}
+
+std::vector<double> Tuner::evaluate(const std::vector<Candidate> & candidates)
+{
+  std::vector<double> scores(candidates.size());
+  std::vector<size_t> toEvaluate;
+  for(size_t i = 0; i < candidates.size(); i++)
+  {
+    auto it = scores_.find(candidates[i]);
+    if(it != scores_.end()) { scores[i] = it->second; }
+    else { toEvaluate.push_back(i); }
+  }
+
+  pool_->parallelFor(toEvaluate.size(),
+                     [&](size_t i)
+                     {
+                       const size_t candidate = toEvaluate[i];
+                       scores[candidate] = score(candidates[candidate]);
+                       mc_rtc::log::info("[{}] Candidate {}/{}: score {}", tunerName, i + 1, toEvaluate.size(),
+                                         scores[candidate]);
+                     });
+
+  for(const auto & i : toEvaluate) { scores_[candidates[i]] = scores[i]; }
+  return scores;
+}
+
+double Tuner::score(const Candidate & candidate) const
+{
+  std::unique_ptr<mc_control::MCGlobalController> gc;
+  double score = std::numeric_limits<double>::infinity();
+  try
+  {
+    gc = createController(candidate);
+    score = replay(*gc);
+  }
+  catch(const std::exception & e)
+  {
+    mc_rtc::log::warning("[{}] The replay failed: {}", tunerName, e.what());
+  }
+  std::lock_guard<std::mutex> lock(controllersMutex_);
+  gc.reset();
+  return score;
+}
+
+std::unique_ptr<mc_control::MCGlobalController> Tuner::createController(const Candidate & candidate) const
+{
+  std::lock_guard<std::mutex> lock(controllersMutex_);
+
+  // each controller reads its own copy of the configuration
+  mc_control::MCGlobalController::GlobalConfiguration gconfig(mcrtcConfig_, nullptr);
+  gconfig.enable_log = false;
+  gconfig.enable_gui_server = false;
+
+  mc_rtc::Configuration observerConfig;
+  bool found = false;
+  for(auto pipelineConfig : gconfig.controllers_configs[gconfig.initial_controller]("ObserverPipelines"))
+  {
+    if(!pipeline_.empty() && static_cast<std::string>(pipelineConfig("name")) != pipeline_) { continue; }
+    for(auto config : pipelineConfig("observers"))
+    {
+      if(config("name", static_cast<std::string>(config("type"))) != observer_) { continue; }
+      if(!config.has("config")) { config.add("config"); }
+      observerConfig = config("config");
+      found = true;
+      break;
+    }
+    if(found || !pipeline_.empty()) { break; }
+  }
+  if(!found)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[{}] The observer {} is not used by the controller {}", tunerName,
+                                                     observer_, gconfig.initial_controller);
+  }
+
+  for(size_t j = 0; j < parameters_.size(); j++)
+  {
+    observerConfig.add(parameters_[j].name, parameters_[j].values[candidate[j]]);
+  }
+  auto captureConfig = observerConfig.add("capture");
+  captureConfig.add("mode", std::string("replay"));
+  captureConfig.add("path", capture_);
+
+  std::unique_ptr<mc_control::MCGlobalController> gc(new mc_control::MCGlobalController(gconfig));
+
+  // the observer replays the captured inputs into its own robots, the controller starts from the stance of the robot
+  const auto & robot = gc->robot();
+  std::vector<double> initq;
+  for(const auto & joint : gc->ref_joint_order())
+  {
+    const auto & q = robot.mbc().q[static_cast<size_t>(robot.jointIndexByName(joint))];
+    initq.push_back(q.empty() ? 0.0 : q[0]);
+  }
+  gc->setEncoderValues(initq);
+  gc->init(initq);
+  return gc;
+}
+
+double Tuner::replay(mc_control::MCGlobalController & gc) const
+{
+  auto & ctl = gc.controller();
+  const auto & pipeline = pipeline_.empty() ? ctl.observerPipeline() : ctl.observerPipeline(pipeline_);
+  const auto & estimatedRobot = ctl.realRobot(robot_.empty() ? ctl.robot().name() : robot_);
+
+  double squaredPositionError = 0.0;
+  double squaredOrientationError = 0.0;
+  size_t nbScored = 0;
+  for(const auto & referenceIndex : referenceIndexes_)
+  {
+    gc.run();
+    // the observer fails if it diverges or if the capture ends before the expected number of frames
+    if(!pipeline.success()) { return std::numeric_limits<double>::infinity(); }
+    if(referenceIndex < 0) { continue; }
+
+    const sva::PTransformd & X_0_ref = referencePoses_[static_cast<size_t>(referenceIndex)];
+    const sva::PTransformd & X_0_fb = estimatedRobot.posW();
+    squaredPositionError += (X_0_fb.translation() - X_0_ref.translation()).squaredNorm();
+    const Eigen::AngleAxisd orientationError(Eigen::Matrix3d(X_0_ref.rotation() * X_0_fb.rotation().transpose()));
+    squaredOrientationError += orientationError.angle() * orientationError.angle();
+    nbScored++;
+  }
+  return std::sqrt(squaredPositionError / static_cast<double>(nbScored))
+         + orientationWeight_ * std::sqrt(squaredOrientationError / static_cast<double>(nbScored));
+}
+
+void Tuner::keepBest(const std::vector<Candidate> & candidates, const std::vector<double> & scores)
+{
+  for(size_t i = 0; i < candidates.size(); i++)
+  {
+    if(scores[i] < bestScore_)
+    {
+      bestScore_ = scores[i];
+      best_ = candidates[i];
+    }
+  }
+}
+
+void Tuner::writeOutput() const
+{
+  mc_rtc::Configuration output;
+  for(size_t j = 0; j < parameters_.size(); j++)
+  {
+    output.add(parameters_[j].name, parameters_[j].values[best_[j]]);
+  }
+  output.save(output_);
+  mc_rtc::log::success("[{}] Best score {} ({} replays), covariances written to {}", tunerName, bestScore_,
+                       scores_.size(), output_);
+}
+
+} // namespace
+
+int main(int argc, char * argv[])
+{
+  if(argc != 2)
+  {
+    std::fprintf(stderr, "Usage: %s <tuning configuration>\n", argv[0]);
+    return 1;
+  }
+
+  try
+  {
+    Tuner tuner(mc_rtc::Configuration(argv[1]));
+    tuner.run();
+  }
+  catch(const std::exception & e)
+  {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+  return 0;
+}
@@ -38,6 +38,7 @@ void MOCAPVisualizer::reset(const mc_control::MCController & ctl)
 
   my_robots_ = mc_rbdyn::Robots::make();
   my_robots_->robotCopy(robot, robot.name());
+  ctl.gui()->removeElement({"Robots"}, "MOCAPVisualizer");
   ctl.gui()->addElement(
       {"Robots"},
       mc_rtc::gui::Robot("MOCAPVisualizer", [this]() -> const mc_rbdyn::Robot & { return my_robots_->robot(); }));
@@ -5,69 +5,162 @@
 namespace mc_state_observation
 {
 
-MocapObserver::MocapObserver(const std::string & type, double dt) : mc_observers::Observer(type, dt) {}
+MocapObserver::MocapObserver(const std::string & type, double dt) : mc_observers::Observer(type, dt)
+{
+  runTiming_ = timer_.addStage("run");
+  updateTiming_ = timer_.addStage("update");
+}
 
 void MocapObserver::configure(const mc_control::MCController & ctl, const mc_rtc::Configuration & config)
 {
-  robot_ = config("robot", ctl.robot().name());
-  updateRobot_ = robot_;
-  config("useReal", useReal_);
-  config("updateRobot", updateRobot_);
-  body_ = config("body", robot(ctl).mb().body(0).name());
+  bodies_.clear();
+  if(config.has("bodies"))
+  {
+    for(const auto & bodyConfig : config("bodies")) { bodies_.push_back(configureBody(ctl, bodyConfig)); }
+    if(bodies_.empty())
+    {
+      mc_rtc::log::error_and_throw<std::runtime_error>("[{}] The list of tracked bodies is empty", name());
+    }
+  }
+  else
+  {
+    // a single tracked body, described directly in the configuration of the observer
+    bodies_.push_back(configureBody(ctl, config));
+    bodies_.back().name.clear();
+  }
+
+  for(size_t i = 0; i < bodies_.size(); i++)
+  {
+    for(size_t j = 0; j < i; j++)
+    {
+      if(bodies_[i].update && bodies_[j].update && bodies_[i].updateRobot == bodies_[j].updateRobot)
+      {
+        mc_rtc::log::error_and_throw<std::runtime_error>("[{}] The bodies {} and {} both update the robot {}", name(),
+                                                         bodies_[j].name, bodies_[i].name, bodies_[i].updateRobot);
+      }
+      if(bodies_[i].name == bodies_[j].name)
+      {
+        mc_rtc::log::error_and_throw<std::runtime_error>("[{}] Two tracked bodies are named {}", name(),
+                                                         bodies_[i].name);
+      }
+    }
+  }
+
+  if(config.has("calibration"))
+  {
+    const auto calibrationConfig = config("calibration");
+    calibrationConfig("samples", calibrationSamples_);
+    calibrationConfig("maxTranslationStd", calibrationMaxTranslationStd_);
+    calibrationConfig("maxOrientationStd", calibrationMaxOrientationStd_);
+    calibrationConfig("maxAttempts", calibrationMaxAttempts_);
+  }
+  calibrationTarget_ = CalibrationTarget::none;
+
+  timer_.enabled(config("withTimings", false));
   desc_ = name_ + " (Marker TF: {} -> {})";
 }
 
+MocapObserver::TrackedBody MocapObserver::configureBody(const mc_control::MCController & ctl,
+                                                        const mc_rtc::Configuration & config) const
+{
+  TrackedBody tracked;
+  tracked.robot = config("robot", ctl.robot().name());
+  tracked.updateRobot = tracked.robot;
+  config("useReal", tracked.useReal);
+  config("updateRobot", tracked.updateRobot);
+  config("update", tracked.update);
+  const auto & robot = tracked.useReal ? ctl.realRobot(tracked.robot) : ctl.robot(tracked.robot);
+  tracked.body = config("body", robot.mb().body(0).name());
+  tracked.name = config("name", tracked.updateRobot + "_" + tracked.body);
+
+  // bodies from the floating base to the body, whose joint transformations give the pose of the body in the floating
+  // base frame. If none of these joints is actuated, this pose is constant.
+  const auto & updateRobot = ctl.realRobot(tracked.updateRobot);
+  const auto & mb = updateRobot.mb();
+  for(int i = static_cast<int>(updateRobot.bodyIndexByName(tracked.body)); i > 0; i = mb.parent(i))
+  {
+    tracked.fbToBodyChain.insert(tracked.fbToBodyChain.begin(), i);
+    if(mb.joint(i).dof() > 0) { tracked.rigidBodyToFb = false; }
+  }
+  if(tracked.rigidBodyToFb)
+  {
+    for(const auto & i : tracked.fbToBodyChain) { tracked.X_fb_body = mb.transform(i) * tracked.X_fb_body; }
+  }
+  return tracked;
+}
+
+std::string MocapObserver::logPrefix(const std::string & category, size_t i) const
+{
+  return bodies_[i].name.empty() ? category : category + "_" + bodies_[i].name;
+}
+
 void MocapObserver::reset(const mc_control::MCController & ctl)
 {
   calibrated_ = false;
+  calibrationTarget_ = CalibrationTarget::none;
   run(ctl);
 }
 
-bool MocapObserver::run(const mc_control::MCController &)
+bool MocapObserver::run(const mc_control::MCController & ctl)
 {
+  auto runTimer = timer_.scope(runTiming_);
+  if(calibrationTarget_ != CalibrationTarget::none) { accumulateCalibration(ctl); }
   if(!calibrated_) { error_ = fmt::format("[{}] Please calibrate the body to marker pose first", name()); }
-  X_0_marker_ = X_m_marker_ * X_0_mocap_;
+  for(auto & tracked : bodies_) { tracked.X_0_marker = tracked.X_m_marker * X_0_mocap_; }
   return calibrated_;
 }
 
 void MocapObserver::update(mc_control::MCController & ctl)
 {
-  auto & updateRobot = ctl.realRobot(updateRobot_);
+  auto updateTimer = timer_.scope(updateTiming_);
 
-  auto X_0_body = updateRobot.bodyPosW(body_);
-  auto X_body_fb = updateRobot.posW() * X_0_body.inv();
-  // Note 1: This renormalizes and reorthogonalizes the rotation matrix to
-  // avoid numerical errors slowly adding up over the course of many
-  // iterations. It would however be better to compute the relative pose
-  // X_b_fb withoug passing through the world frame, which would not be
-  // subject from this denormalization issue.
-  // Note 2: This issue only occurs for fixed-base robots, as the posW()
-  // performs the quaternion conversion and normalization itself
+  for(auto & tracked : bodies_)
   {
-    Eigen::Quaterniond rot(X_body_fb.rotation());
-    rot.normalize();
-    X_body_fb.rotation() = rot.toRotationMatrix();
+    auto & updateRobot = ctl.realRobot(tracked.updateRobot);
+
+    // The pose of the body in the floating base frame is obtained from the joints between them, without passing
+    // through the world frame. It is therefore not subject to the accumulation of numerical errors that required to
+    // re-orthogonalize the rotation of updateRobot.posW() * X_0_body.inv().
+    if(!tracked.rigidBodyToFb)
+    {
+      const auto & parentToSon = updateRobot.mbc().parentToSon;
+      tracked.X_fb_body = sva::PTransformd::Identity();
+      for(const auto & i : tracked.fbToBodyChain) { tracked.X_fb_body = parentToSon[i] * tracked.X_fb_body; }
+    }
+    tracked.X_0_fb = tracked.X_fb_body.inv() * tracked.X_marker_body * tracked.X_0_marker;
+    if(tracked.update) { updateRobot.posW(tracked.X_0_fb); }
   }
-  X_0_fb_ = X_body_fb * X_marker_body_ * X_0_marker_;
-  updateRobot.posW(X_0_fb_);
 }
 
 void MocapObserver::addToLogger(const mc_control::MCController &, mc_rtc::Logger & logger, const std::string & category)
 {
-  logger.addLogEntry(category + "_MocapToMarker", [this]() -> const sva::PTransformd & { return X_m_marker_; });
-  logger.addLogEntry(category + "_markerPosW", [this]() -> const sva::PTransformd & { return X_0_marker_; });
-  logger.addLogEntry(category + "_posW", [this]() -> const sva::PTransformd & { return X_0_fb_; });
+  for(size_t i = 0; i < bodies_.size(); i++)
+  {
+    const std::string prefix = logPrefix(category, i);
+    const TrackedBody & tracked = bodies_[i];
+    logger.addLogEntry(prefix + "_MocapToMarker",
+                       [&tracked]() -> const sva::PTransformd & { return tracked.X_m_marker; });
+    logger.addLogEntry(prefix + "_markerPosW", [&tracked]() -> const sva::PTransformd & { return tracked.X_0_marker; });
+    logger.addLogEntry(prefix + "_posW", [&tracked]() -> const sva::PTransformd & { return tracked.X_0_fb; });
+    logger.addLogEntry(prefix + "_marker_to_body",
+                       [&tracked]() -> const sva::PTransformd & { return tracked.X_marker_body; });
+  }
   logger.addLogEntry(category + "_MocapOrigin", [this]() -> const sva::PTransformd & { return X_0_mocap_; });
-  logger.addLogEntry(category + "_marker_to_body", [this]() -> const sva::PTransformd & { return X_marker_body_; });
+  timer_.addToLogger(logger, category);
 }
 
 void MocapObserver::removeFromLogger(mc_rtc::Logger & logger, const std::string & category)
 {
-  logger.removeLogEntry(category + "_MocapToMarker");
-  logger.removeLogEntry(category + "_markerPosW");
-  logger.removeLogEntry(category + "_posW");
+  for(size_t i = 0; i < bodies_.size(); i++)
+  {
+    const std::string prefix = logPrefix(category, i);
+    logger.removeLogEntry(prefix + "_MocapToMarker");
+    logger.removeLogEntry(prefix + "_markerPosW");
+    logger.removeLogEntry(prefix + "_posW");
+    logger.removeLogEntry(prefix + "_marker_to_body");
+  }
   logger.removeLogEntry(category + "_MocapOrigin");
-  logger.removeLogEntry(category + "_marker_to_body");
+  timer_.removeFromLogger(logger, category);
 }
 
 void MocapObserver::addToGUI(const mc_control::MCController & ctl,
@@ -76,6 +169,15 @@ void MocapObserver::addToGUI(const mc_control::MCController & ctl,
 {
   gui.addElement(
       category,
+      mc_rtc::gui::Label("Calibration",
+                         [this]() -> std::string
+                         {
+                           if(calibrationTarget_ == CalibrationTarget::none) { return calibrated_ ? "done" : "none"; }
+                           return fmt::format("{} ({}/{} samples, attempt {}/{})",
+                                              calibrationTarget_ == CalibrationTarget::markers ? "markers" : "origin",
+                                              bodies_.front().calibrationSamples.nbSamples, calibrationSamples_,
+                                              calibrationAttempt_ + 1, calibrationMaxAttempts_);
+                         }),
       mc_rtc::gui::Button("Calibrate Marker (put robot at mocap origin)",
                           [this, &ctl]()
                           {
@@ -96,15 +198,23 @@ void MocapObserver::addToGUI(const mc_control::MCController & ctl,
                           }),
       mc_rtc::gui::Transform(
           "Mocap Origin", [this]() -> const sva::PTransformd & { return X_0_mocap_; },
-          [this](const sva::PTransformd & pose) { X_0_mocap_ = pose; }),
-      mc_rtc::gui::Transform("Mocap Marker World", [this]() -> const sva::PTransformd & { return X_0_marker_; }),
-      mc_rtc::gui::Transform("Mocap Marker Frame",
-                             [this, &ctl]() -> const sva::PTransformd
-                             {
-                               auto & realRobot = ctl.realRobot(updateRobot_);
-                               auto X_0_body = realRobot.bodyPosW(body_);
-                               return X_marker_body_.inv() * X_0_body;
-                             }));
+          [this](const sva::PTransformd & pose) { X_0_mocap_ = pose; }));
+  for(const auto & tracked : bodies_)
+  {
+    std::vector<std::string> bodyCategory = category;
+    if(!tracked.name.empty()) { bodyCategory.push_back(tracked.name); }
+    gui.addElement(bodyCategory,
+                   mc_rtc::gui::Transform("Mocap Marker World",
+                                          [&tracked]() -> const sva::PTransformd & { return tracked.X_0_marker; }),
+                   mc_rtc::gui::Transform("Mocap Marker Frame",
+                                          [&tracked, &ctl]() -> const sva::PTransformd
+                                          {
+                                            auto & realRobot = ctl.realRobot(tracked.updateRobot);
+                                            auto X_0_body = realRobot.bodyPosW(tracked.body);
+                                            return tracked.X_marker_body.inv() * X_0_body;
+                                          }));
+  }
+  timer_.addToGUI(gui, category);
 }
 
 bool MocapObserver::checkPipelines(const mc_control::MCController & ctl)
@@ -117,6 +227,23 @@ bool MocapObserver::checkPipelines(const mc_control::MCController & ctl)
   return pipelineSuccess;
 }
 
+sva::PTransformd MocapObserver::markerToBodySample(const mc_control::MCController & ctl, size_t i) const
+{
+  // In general, the robot should be placed at the origin of the mocap system
+  // before this operation.
+  // If this is not the case, set X_0_mocap_ appropriately manually
+  auto X_0_body = robot(ctl, i).bodyPosW(bodies_[i].body);
+  return X_0_body * X_0_mocap_.inv() * bodies_[i].X_m_marker.inv();
+}
+
+sva::PTransformd MocapObserver::originSample(const mc_control::MCController & ctl) const
+{
+  // the origin is shared by all the tracked bodies, it is obtained from the first one
+  const auto & tracked = bodies_.front();
+  auto X_0_body = robot(ctl).bodyPosW(tracked.body);
+  return tracked.X_m_marker.inv() * tracked.X_marker_body.inv() * X_0_body;
+}
+
 bool MocapObserver::calibrateMarkerToBody(const mc_control::MCController & ctl)
 {
   if(!checkPipelines(ctl))
@@ -124,34 +251,162 @@ bool MocapObserver::calibrateMarkerToBody(const mc_control::MCController & ctl)
     mc_rtc::log::error("[{}] Calibration failed: other pipelines are not ready", name());
     return false;
   }
-  if(!gotMarker_)
+  for(const auto & tracked : bodies_)
+  {
+    if(!tracked.gotMarker)
+    {
+      mc_rtc::log::error("[{}] Calibration failed: didn't receive any mocap marker pose for body {} yet", name(),
+                         tracked.body);
+      return false;
+    }
+  }
+
+  if(calibrationSamples_ > 1)
   {
-    mc_rtc::log::error("[{}] Calibration failed: didn't receive any mocap marker pose yet", name());
+    for(auto & tracked : bodies_) { tracked.calibrationSamples.reset(); }
+    calibrationTarget_ = CalibrationTarget::markers;
+    calibrationAttempt_ = 0;
+    mc_rtc::log::info("[{}] Accumulating {} samples for the calibration, keep the robot still", name(),
+                      calibrationSamples_);
     return false;
   }
 
-  auto X_0_body = robot(ctl).bodyPosW(body_);
-  // In general, the robot should be placed at the origin of the mocap system
-  // before this operation.
-  // If this is not the case, set X_0_mocap_ appropriately manually
-  X_marker_body_ = X_0_body * X_0_mocap_.inv() * X_m_marker_.inv();
+  for(size_t i = 0; i < bodies_.size(); i++) { bodies_[i].X_marker_body = markerToBodySample(ctl, i); }
   mc_rtc::log::success("[{}] calibrated.", name());
-  mc_rtc::log::info("[{}] Transformation between mocap marker and body {} \ntranslation: {}\nrotation: {}", name(),
-                    body_, X_marker_body_.translation().transpose(),
-                    mc_rbdyn::rpyFromMat(X_marker_body_.rotation()).transpose());
+  for(const auto & tracked : bodies_)
+  {
+    mc_rtc::log::info("[{}] Transformation between mocap marker and body {} \ntranslation: {}\nrotation: {}", name(),
+                      tracked.body, tracked.X_marker_body.translation().transpose(),
+                      mc_rbdyn::rpyFromMat(tracked.X_marker_body.rotation()).transpose());
+  }
   return true;
 }
 
 bool MocapObserver::initializeOrigin(const mc_control::MCController & ctl)
 {
   if(!checkPipelines(ctl)) return false;
-  if(!gotMarker_) return false;
+  if(!bodies_.front().gotMarker) return false;
 
-  auto X_0_body = robot(ctl).bodyPosW(body_);
-  X_0_mocap_ = X_m_marker_.inv() * X_marker_body_.inv() * X_0_body;
+  if(calibrationSamples_ > 1)
+  {
+    bodies_.front().calibrationSamples.reset();
+    calibrationTarget_ = CalibrationTarget::origin;
+    calibrationAttempt_ = 0;
+    mc_rtc::log::info("[{}] Accumulating {} samples for the origin, keep the robot still", name(),
+                      calibrationSamples_);
+    return false;
+  }
+
+  X_0_mocap_ = originSample(ctl);
   mc_rtc::log::success("[{}] World to mocap transformation.\ntranslation: {}\nrotation: {}", name(),
                        X_0_mocap_.translation().transpose(), mc_rbdyn::rpyFromMat(X_0_mocap_.rotation()).transpose());
   return true;
 }
 
+void MocapObserver::accumulateCalibration(const mc_control::MCController & ctl)
+{
+  const bool markers = calibrationTarget_ == CalibrationTarget::markers;
+  const size_t nbAccumulators = markers ? bodies_.size() : 1;
+
+  for(size_t i = 0; i < nbAccumulators; i++)
+  {
+    bodies_[i].calibrationSamples.add(markers ? markerToBodySample(ctl, i) : originSample(ctl));
+  }
+  if(bodies_.front().calibrationSamples.nbSamples < calibrationSamples_) { return; }
+
+  bool stable = true;
+  for(size_t i = 0; i < nbAccumulators; i++)
+  {
+    const auto & samples = bodies_[i].calibrationSamples;
+    if(samples.translationStd() > calibrationMaxTranslationStd_
+       || samples.orientationStd() > calibrationMaxOrientationStd_)
+    {
+      mc_rtc::log::warning("[{}] The samples of body {} vary too much (translation: {:.2e}m, orientation: {:.2e}rad)",
+                           name(), bodies_[i].body, samples.translationStd(), samples.orientationStd());
+      stable = false;
+    }
+  }
+
+  if(!stable)
+  {
+    if(++calibrationAttempt_ >= calibrationMaxAttempts_)
+    {
+      mc_rtc::log::error("[{}] Calibration failed: the samples vary too much, keep the robot still", name());
+      calibrationTarget_ = CalibrationTarget::none;
+      return;
+    }
+    for(size_t i = 0; i < nbAccumulators; i++) { bodies_[i].calibrationSamples.reset(); }
+    return;
+  }
+
+  calibrationTarget_ = CalibrationTarget::none;
+  if(markers)
+  {
+    for(auto & tracked : bodies_)
+    {
+      tracked.X_marker_body = tracked.calibrationSamples.mean();
+      mc_rtc::log::info("[{}] Transformation between mocap marker and body {} \ntranslation: {}\nrotation: {}",
+                        name(), tracked.body, tracked.X_marker_body.translation().transpose(),
+                        mc_rbdyn::rpyFromMat(tracked.X_marker_body.rotation()).transpose());
+    }
+    calibrated_ = true;
+    mc_rtc::log::success("[{}] calibrated from {} samples.", name(), calibrationSamples_);
+  }
+  else
+  {
+    X_0_mocap_ = bodies_.front().calibrationSamples.mean();
+    originInitialized_ = true;
+    mc_rtc::log::success("[{}] World to mocap transformation from {} samples.\ntranslation: {}\nrotation: {}",
+                         name(), calibrationSamples_, X_0_mocap_.translation().transpose(),
+                         mc_rbdyn::rpyFromMat(X_0_mocap_.rotation()).transpose());
+  }
+}
+
+///////////////////////////////////////////////////////////////////////
+/// --------------------------Pose accumulator-------------------------
+///////////////////////////////////////////////////////////////////////
+
+void MocapObserver::PoseAccumulator::add(const sva::PTransformd & pose)
+{
+  nbSamples++;
+  // the rotation of a PTransform is the transpose of the orientation of the frame
+  const Eigen::Quaterniond orientation(Eigen::Matrix3d(pose.rotation().transpose()));
+  if(nbSamples == 1)
+  {
+    meanTranslation = pose.translation();
+    meanOrientation = orientation;
+    translationM2.setZero();
+    orientationM2.setZero();
+    return;
+  }
+
+  const Eigen::Vector3d translationDiff = pose.translation() - meanTranslation;
+  meanTranslation += translationDiff / static_cast<double>(nbSamples);
+  translationM2.noalias() += translationDiff * (pose.translation() - meanTranslation).transpose();
+
+  const Eigen::AngleAxisd orientationDiff(meanOrientation.conjugate() * orientation);
+  const Eigen::Vector3d rotationVector = orientationDiff.angle() * orientationDiff.axis();
+  const Eigen::AngleAxisd meanStep(orientationDiff.angle() / static_cast<double>(nbSamples), orientationDiff.axis());
+  meanOrientation = (meanOrientation * meanStep).normalized();
+  // relatively to the updated mean, the rotation vector of the sample is (1 - 1/n) times the previous one
+  orientationM2.noalias() += (1.0 - 1.0 / static_cast<double>(nbSamples)) * rotationVector * rotationVector.transpose();
+}
+
+sva::PTransformd MocapObserver::PoseAccumulator::mean() const
+{
+  return sva::PTransformd(Eigen::Matrix3d(meanOrientation.toRotationMatrix().transpose()), meanTranslation);
+}
+
+double MocapObserver::PoseAccumulator::translationStd() const
+{
+  if(nbSamples < 2) { return 0.0; }
+  return std::sqrt(translationM2.trace() / static_cast<double>(nbSamples - 1));
+}
+
+double MocapObserver::PoseAccumulator::orientationStd() const
+{
+  if(nbSamples < 2) { return 0.0; }
+  return std::sqrt(orientationM2.trace() / static_cast<double>(nbSamples - 1));
+}
+
 } // namespace mc_state_observation
@@ -4,6 +4,8 @@
 
 #include <SpaceVecAlg/Conversions.h>
 
+#include <fmt/ranges.h>
+
 namespace mc_state_observation
 {
 
@@ -14,15 +16,30 @@ MocapObserverROS::MocapObserverROS(const std::string & type, double dt)
   tfBuffer_(nh_->get_clock())
 #endif
 {
+  lookupTiming_ = timer_.addStage("lookupTransform");
 }
 
 void MocapObserverROS::configure(const mc_control::MCController & ctl, const mc_rtc::Configuration & config)
 {
   MocapObserver::configure(ctl, config);
-  config("marker_tf", marker_);
   config("marker_origin_tf", markerOrigin_);
-  desc_ =
-      fmt::format("{} (Marker TF: {} -> {}, Body: {}, Update: {})", name_, markerOrigin_, marker_, body_, updateRobot_);
+  markers_.clear();
+  if(config.has("bodies"))
+  {
+    for(const auto & bodyConfig : config("bodies")) { markers_.push_back(bodyConfig("marker_tf")); }
+    std::vector<std::string> bodiesDesc;
+    for(size_t i = 0; i < bodies_.size(); i++)
+    {
+      bodiesDesc.push_back(fmt::format("{} -> {}/{}", markers_[i], bodies_[i].updateRobot, bodies_[i].body));
+    }
+    desc_ = fmt::format("{} (Marker TF: {}, Bodies: [{}])", name_, markerOrigin_, fmt::join(bodiesDesc, ", "));
+  }
+  else
+  {
+    markers_.push_back(config("marker_tf", std::string("mocap/base_link")));
+    desc_ = fmt::format("{} (Marker TF: {} -> {}, Body: {}, Update: {})", name_, markerOrigin_, markers_.front(),
+                        bodies_.front().body, bodies_.front().updateRobot);
+  }
 }
 
 void MocapObserverROS::reset(const mc_control::MCController & ctl)
@@ -32,18 +49,24 @@ void MocapObserverROS::reset(const mc_control::MCController & ctl)
 
 bool MocapObserverROS::run(const mc_control::MCController & ctl)
 {
-  TransformStamped transformStamped;
-  try
-  {
-    transformStamped = tfBuffer_.lookupTransform(markerOrigin_, marker_, RosTime(0));
-  }
-  catch(tf2::TransformException & ex)
   {
-    error_ = ex.what();
-    return false;
+    auto lookupTimer = timer_.scope(lookupTiming_);
+    for(size_t i = 0; i < markers_.size(); i++)
+    {
+      TransformStamped transformStamped;
+      try
+      {
+        transformStamped = tfBuffer_.lookupTransform(markerOrigin_, markers_[i], RosTime(0));
+      }
+      catch(tf2::TransformException & ex)
+      {
+        error_ = ex.what();
+        return false;
+      }
+      auto pose = sva::conversions::fromHomogeneous(tf2::transformToEigen(transformStamped).matrix());
+      MocapObserver::markerPose(i, pose);
+    }
   }
-  auto pose = sva::conversions::fromHomogeneous(tf2::transformToEigen(transformStamped).matrix());
-  MocapObserver::markerPose(pose);
 
   return MocapObserver::run(ctl);
 }
@@ -0,0 +1,186 @@
+#include <mc_state_observation/MocapObserverUDP.h>
+#include <mc_state_observation/MocapUDPPacket.h>
+
+#include <mc_observers/ObserverMacros.h>
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace mc_state_observation
+{
+
+MocapObserverUDP::MocapObserverUDP(const std::string & type, double dt) : MocapObserver(type, dt) {}
+
+MocapObserverUDP::~MocapObserverUDP()
+{
+  stopReception();
+}
+
+void MocapObserverUDP::configure(const mc_control::MCController & ctl, const mc_rtc::Configuration & config)
+{
+  // the receive thread reads the configuration
+  stopReception();
+
+  MocapObserver::configure(ctl, config);
+  config("address", address_);
+  config("port", port_);
+  config("timeout", timeout_);
+
+  if(bodies_.size() > mocapUDPMaxMarkers)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[{}] At most {} bodies can be tracked", name(),
+                                                     mocapUDPMaxMarkers);
+  }
+  markerIds_.clear();
+  if(config.has("bodies"))
+  {
+    for(const auto & bodyConfig : config("bodies"))
+    {
+      markerIds_.push_back(bodyConfig("marker", static_cast<uint32_t>(markerIds_.size())));
+    }
+  }
+  else { markerIds_.push_back(config("marker", 0u)); }
+  receptionTimes_.assign(bodies_.size(), std::chrono::steady_clock::time_point());
+
+  desc_ = fmt::format("{} (UDP: {}:{}, Bodies: {})", name_, address_, port_, bodies_.size());
+
+  sockaddr_in socketAddress;
+  std::memset(&socketAddress, 0, sizeof(socketAddress));
+  socketAddress.sin_family = AF_INET;
+  socketAddress.sin_port = htons(static_cast<uint16_t>(port_));
+  if(inet_pton(AF_INET, address_.c_str(), &socketAddress.sin_addr) != 1)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[{}] Invalid address {}", name(), address_);
+  }
+
+  socket_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+  // the receive thread wakes up regularly to check if it must stop
+  timeval receiveTimeout{0, 100000};
+  if(socket_ < 0 || ::setsockopt(socket_, SOL_SOCKET, SO_RCVTIMEO, &receiveTimeout, sizeof(receiveTimeout)) != 0
+     || ::bind(socket_, reinterpret_cast<const sockaddr *>(&socketAddress), sizeof(socketAddress)) != 0)
+  {
+    const std::string error = std::strerror(errno);
+    stopReception();
+    mc_rtc::log::error_and_throw<std::runtime_error>("[{}] Could not listen on {}:{}: {}", name(), address_, port_,
+                                                     error);
+  }
+
+  stop_ = false;
+  receiveThread_ = std::thread([this]() { receiveLoop(); });
+  if(config.has("thread")) { threadingTools::configureThread(receiveThread_, config("thread"), name()); }
+}
+
+void MocapObserverUDP::reset(const mc_control::MCController & ctl)
+{
+  MocapObserver::reset(ctl);
+}
+
+bool MocapObserverUDP::run(const mc_control::MCController & ctl)
+{
+  const auto now = std::chrono::steady_clock::now();
+  if(markersSlot_.consume())
+  {
+    const MarkersFrame & frame = markersSlot_.front();
+    for(size_t i = 0; i < bodies_.size(); i++)
+    {
+      if((frame.received & (uint64_t(1) << i)) == 0) { continue; }
+      MocapObserver::markerPose(i, frame.poses[i]);
+      receptionTimes_[i] = frame.receptionTime;
+    }
+    sequence_ = frame.sequence;
+    latency_ = std::chrono::duration<double, std::milli>(now - frame.receptionTime).count();
+  }
+
+  for(size_t i = 0; i < bodies_.size(); i++)
+  {
+    if(!bodies_[i].gotMarker)
+    {
+      error_ = fmt::format("[{}] No pose of marker {} received on {}:{} yet", name(), markerIds_[i], address_, port_);
+      return false;
+    }
+    const double age = std::chrono::duration<double>(now - receptionTimes_[i]).count();
+    if(age > timeout_)
+    {
+      error_ = fmt::format("[{}] The last pose of marker {} was received {:.3f}s ago", name(), markerIds_[i], age);
+      return false;
+    }
+  }
+
+  return MocapObserver::run(ctl);
+}
+
+void MocapObserverUDP::receiveLoop()
+{
+  MocapUDPPacket packet;
+  while(!stop_)
+  {
+    const ssize_t size = ::recv(socket_, &packet, sizeof(packet), 0);
+    // timeout or interruption
+    if(size < 0) { continue; }
+    if(static_cast<size_t>(size) < mocapUDPPacketSize(0)
+       || std::memcmp(packet.magic, mocapUDPMagic, sizeof(mocapUDPMagic)) != 0 || packet.nbMarkers > mocapUDPMaxMarkers
+       || static_cast<size_t>(size) != mocapUDPPacketSize(packet.nbMarkers))
+    {
+      invalidPackets_++;
+      continue;
+    }
+
+    MarkersFrame & frame = markersSlot_.back();
+    frame.receptionTime = std::chrono::steady_clock::now();
+    frame.sequence = packet.sequence;
+    frame.received = 0;
+    for(uint32_t m = 0; m < packet.nbMarkers; m++)
+    {
+      const MocapUDPMarker & marker = packet.markers[m];
+      for(size_t i = 0; i < markerIds_.size(); i++)
+      {
+        if(markerIds_[i] != marker.id) { continue; }
+        Eigen::Quaterniond orientation(marker.rotation[0], marker.rotation[1], marker.rotation[2], marker.rotation[3]);
+        orientation.normalize();
+        // the rotation of a PTransform is the transpose of the orientation of the frame
+        frame.poses[i] = sva::PTransformd(orientation.conjugate(), Eigen::Vector3d(marker.translation[0],
+                                                                                   marker.translation[1],
+                                                                                   marker.translation[2]));
+        frame.received |= uint64_t(1) << i;
+      }
+    }
+    markersSlot_.publish();
+  }
+}
+
+void MocapObserverUDP::stopReception()
+{
+  stop_ = true;
+  if(receiveThread_.joinable()) { receiveThread_.join(); }
+  if(socket_ >= 0)
+  {
+    ::close(socket_);
+    socket_ = -1;
+  }
+}
+
+void MocapObserverUDP::addToLogger(const mc_control::MCController & ctl,
+                                   mc_rtc::Logger & logger,
+                                   const std::string & category)
+{
+  MocapObserver::addToLogger(ctl, logger, category);
+  logger.addLogEntry(category + "_sequence", [this]() { return static_cast<double>(sequence_); });
+  logger.addLogEntry(category + "_latency", [this]() { return latency_; });
+  logger.addLogEntry(category + "_invalidPackets", [this]() { return static_cast<double>(invalidPackets_.load()); });
+}
+
+void MocapObserverUDP::removeFromLogger(mc_rtc::Logger & logger, const std::string & category)
+{
+  MocapObserver::removeFromLogger(logger, category);
+  logger.removeLogEntry(category + "_sequence");
+  logger.removeLogEntry(category + "_latency");
+  logger.removeLogEntry(category + "_invalidPackets");
+}
+
+} // namespace mc_state_observation
+
+EXPORT_OBSERVER_MODULE("MocapObserverUDP", mc_state_observation::MocapObserverUDP)
@@ -0,0 +1,96 @@
+/**
+ * Stand-in for a motion capture system, sending MocapUDPPacket datagrams to a MocapObserverUDP.
+ * Each frame contains the given number of markers, of identifiers 0 to nbMarkers - 1. The marker i follows a circle of
+ * 10cm radius at 1m height, centered at 1m * i along the x axis, while rotating around the vertical axis.
+ *
+ * Usage: mc_state_observation_mocap_udp_sender [address (127.0.0.1)] [port (9870)] [rate in Hz (500)] [nbMarkers (1)]
+ **/
+
+#include <mc_state_observation/MocapUDPPacket.h>
+
+#include <arpa/inet.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace mc_state_observation;
+
+int main(int argc, char * argv[])
+{
+  const std::string address = argc > 1 ? argv[1] : "127.0.0.1";
+  const int port = argc > 2 ? std::atoi(argv[2]) : 9870;
+  const double rate = argc > 3 ? std::atof(argv[3]) : 500.0;
+  const int nbMarkers = argc > 4 ? std::atoi(argv[4]) : 1;
+  if(port <= 0 || rate <= 0.0 || nbMarkers <= 0 || nbMarkers > static_cast<int>(mocapUDPMaxMarkers))
+  {
+    std::fprintf(stderr, "Usage: %s [address] [port] [rate] [nbMarkers (at most %zu)]\n", argv[0], mocapUDPMaxMarkers);
+    return 1;
+  }
+
+  sockaddr_in destination;
+  std::memset(&destination, 0, sizeof(destination));
+  destination.sin_family = AF_INET;
+  destination.sin_port = htons(static_cast<uint16_t>(port));
+  if(inet_pton(AF_INET, address.c_str(), &destination.sin_addr) != 1)
+  {
+    std::fprintf(stderr, "Invalid address %s\n", address.c_str());
+    return 1;
+  }
+
+  const int fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+  if(fd < 0)
+  {
+    std::perror("socket");
+    return 1;
+  }
+
+  std::printf("Sending %d marker poses to %s:%d at %.0fHz\n", nbMarkers, address.c_str(), port, rate);
+
+  MocapUDPPacket packet;
+  std::memset(&packet, 0, sizeof(packet));
+  std::memcpy(packet.magic, mocapUDPMagic, sizeof(mocapUDPMagic));
+  packet.nbMarkers = static_cast<uint32_t>(nbMarkers);
+  const size_t packetSize = mocapUDPPacketSize(packet.nbMarkers);
+  const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(1.0 / rate));
+  const auto start = std::chrono::steady_clock::now();
+  auto next = start;
+  for(uint32_t sequence = 0;; sequence++)
+  {
+    const double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const double angle = 0.5 * t;
+
+    packet.sequence = sequence;
+    for(int i = 0; i < nbMarkers; i++)
+    {
+      MocapUDPMarker & marker = packet.markers[i];
+      marker.id = static_cast<uint32_t>(i);
+      marker.translation[0] = 1.0 * i + 0.1 * std::cos(angle);
+      marker.translation[1] = 0.1 * std::sin(angle);
+      marker.translation[2] = 1.0;
+      // rotation of angle around the z axis
+      marker.rotation[0] = std::cos(angle / 2);
+      marker.rotation[1] = 0.0;
+      marker.rotation[2] = 0.0;
+      marker.rotation[3] = std::sin(angle / 2);
+    }
+
+    if(::sendto(fd, &packet, packetSize, 0, reinterpret_cast<const sockaddr *>(&destination), sizeof(destination)) < 0)
+    {
+      std::perror("sendto");
+    }
+
+    next += period;
+    std::this_thread::sleep_until(next);
+  }
+
+  ::close(fd);
+  return 0;
+}
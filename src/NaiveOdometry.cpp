@@ -17,7 +17,11 @@
 
 namespace mc_state_observation
 {
-NaiveOdometry::NaiveOdometry(const std::string & type, double dt) : mc_observers::Observer(type, dt) {}
+NaiveOdometry::NaiveOdometry(const std::string & type, double dt) : mc_observers::Observer(type, dt)
+{
+  runTiming_ = timer_.addStage("run");
+  updateTiming_ = timer_.addStage("update");
+}
 
 ///////////////////////////////////////////////////////////////////////
 /// --------------------------Core functions---------------------------
@@ -30,6 +34,8 @@ void NaiveOdometry::configure(const mc_control::MCController & ctl, const mc_rtc
   measurements::OdometryType odometryType;
 
   bool verbose = config("verbose", true);
+  timer_.enabled(config("withTimings", false));
+  displayRobot_.configure(config("guiRate", 30.), ctl.timeStep);
 
   if(typeOfOdometry == "flatOdometry") { odometryType = measurements::flatOdometry; }
   else if(typeOfOdometry == "6dOdometry") { odometryType = measurements::odometry6d; }
@@ -140,11 +146,7 @@ void NaiveOdometry::reset(const mc_control::MCController & ctl)
 
   mass(ctl.realRobot(robot_).mass());
 
-  my_robots_ = mc_rbdyn::Robots::make();
-  my_robots_->robotCopy(robot, robot.name());
-  ctl.gui()->addElement(
-      {"Robots"},
-      mc_rtc::gui::Robot("NaiveOdometry", [this]() -> const mc_rbdyn::Robot & { return my_robots_->robot(); }));
+  displayRobot_.reset(*ctl.gui(), {"Robots"}, "NaiveOdometry", robot);
 
   X_0_fb_.translation() = realRobot.posW().translation();
   X_0_fb_.rotation() = realRobot.posW().rotation();
@@ -152,6 +154,7 @@ void NaiveOdometry::reset(const mc_control::MCController & ctl)
 
 bool NaiveOdometry::run(const mc_control::MCController & ctl)
 {
+  auto runTimer = timer_.scope(runTiming_);
   auto & logger = (const_cast<mc_control::MCController &>(ctl)).logger();
 
   //  if the acceleration was estimated by a previous estimator, it can be updated
@@ -159,8 +162,7 @@ bool NaiveOdometry::run(const mc_control::MCController & ctl)
   else { odometryManager_.run(ctl, logger, X_0_fb_, v_fb_0_); }
 
   /* Update of the visual representation (only a visual feature) of the observed robot */
-  my_robots_->robot().mbc().q = ctl.realRobot().mbc().q;
-  update(my_robots_->robot());
+  displayRobot_.update(ctl.realRobot(), [this](mc_rbdyn::Robot & displayed) { update(displayed); });
 
   return true;
 }
@@ -172,6 +174,7 @@ bool NaiveOdometry::run(const mc_control::MCController & ctl)
 void NaiveOdometry::update(mc_control::MCController & ctl) // this function is called by the pipeline if the
                                                            // update is set to true in the configuration file
 {
+  auto updateTimer = timer_.scope(updateTiming_);
   auto & realRobot = ctl.realRobot(robot_);
   update(realRobot);
 }
@@ -202,6 +205,8 @@ void NaiveOdometry::addToLogger(const mc_control::MCController &, mc_rtc::Logger
                      [this]() -> double { return -so::kine::rotationMatrixToYawAxisAgnostic(X_0_fb_.rotation()); });
 
   logger.addLogEntry(category + "_constants_forceThreshold", [this]() -> double { return contactDetectionThreshold_; });
+
+  timer_.addToLogger(logger, category);
 }
 
 void NaiveOdometry::removeFromLogger(mc_rtc::Logger & logger, const std::string & category)
@@ -211,19 +216,14 @@ void NaiveOdometry::removeFromLogger(mc_rtc::Logger & logger, const std::string
   logger.removeLogEntry(category + "_mass");
   logger.removeLogEntry(category + "_flexStiffness");
   logger.removeLogEntry(category + "_flexDamping");
+  timer_.removeFromLogger(logger, category);
 }
 
 void NaiveOdometry::addToGUI(const mc_control::MCController &,
                              mc_rtc::gui::StateBuilder & gui,
                              const std::vector<std::string> & category)
 {
-  using namespace mc_rtc::gui;
-  // unused variables
-  (void)gui;
-  (void)category;
-  // clang-format off
-
-  // clang-format on
+  timer_.addToGUI(gui, category);
 }
 
 } // namespace mc_state_observation
@@ -14,10 +14,20 @@ namespace mc_state_observation
 ObjectObserver::ObjectObserver(const std::string & type, double dt)
 : mc_observers::Observer(type, dt), nh_(mc_rtc::ROSBridge::get_node_handle())
 {
+  runTiming_ = timer_.addStage("run");
+  updateTiming_ = timer_.addStage("update");
+}
+
+ObjectObserver::~ObjectObserver()
+{
+  stopSpinner();
 }
 
 void ObjectObserver::configure(const mc_control::MCController & controller, const mc_rtc::Configuration & config)
 {
+  // the ROS thread reads the configuration
+  stopSpinner();
+
   mc_control::MCController & ctl = const_cast<mc_control::MCController &>(controller);
   if(config.has("Robot"))
   {
@@ -43,6 +53,8 @@ void ObjectObserver::configure(const mc_control::MCController & controller, cons
 
   if(config.has("Publish")) { isPublished_ = config("Publish")("use", true); }
 
+  timer_.enabled(config("withTimings", false));
+
   ctl.datastore().make_call(object_ + "::Robot",
                             [this, &ctl]() -> const mc_rbdyn::Robot & { return ctl.realRobot(object_); });
 
@@ -88,18 +100,22 @@ void ObjectObserver::configure(const mc_control::MCController & controller, cons
 
   desc_ = fmt::format("{} (Object: {}, Topic: {}, inRobotMap: {})", name(), object_, topic_, isInRobotMap_);
 
+  stopSpinner_ = false;
   thread_ = std::thread(std::bind(&ObjectObserver::rosSpinner, this));
+  if(config.has("thread")) { threadingTools::configureThread(thread_, config("thread"), name()); }
 }
 
 void ObjectObserver::reset(const mc_control::MCController &) {}
 
 bool ObjectObserver::run(const mc_control::MCController &)
 {
+  auto runTimer = timer_.scope(runTiming_);
   return true;
 }
 
 void ObjectObserver::update(mc_control::MCController & ctl)
 {
+  auto updateTimer = timer_.scope(updateTiming_);
   {
     const std::lock_guard<std::mutex> lock(mutex_);
     ctl.datastore().assign<bool>("Object::" + object_ + "::IsValid", isEstimatedPoseValid_);
@@ -174,6 +190,7 @@ void ObjectObserver::addToLogger(const mc_control::MCController & ctl,
                        sva::PTransformd X_0_object = ctl.robot(object_).posW();
                        return X_0_object * X_0_camera.inv();
                      });
+  timer_.addToLogger(logger, category);
 }
 
 void ObjectObserver::removeFromLogger(mc_rtc::Logger & logger, const std::string & category)
@@ -183,6 +200,7 @@ void ObjectObserver::removeFromLogger(mc_rtc::Logger & logger, const std::string
   logger.removeLogEntry(category + "_X_Camera_Object_Estimated");
   logger.removeLogEntry(category + "_X_Camera_Object_Real");
   logger.removeLogEntry(category + "_X_Camera_Object_Control");
+  timer_.removeFromLogger(logger, category);
 }
 
 void ObjectObserver::addToGUI(const mc_control::MCController & ctl,
@@ -197,6 +215,7 @@ void ObjectObserver::addToGUI(const mc_control::MCController & ctl,
                                           const std::lock_guard<std::mutex> lock(mutex_);
                                           return X_Camera_EstimatedObject_;
                                         }));
+  timer_.addToGUI(gui, category);
 }
 
 void ObjectObserver::callback(const PoseStamped & msg)
@@ -221,7 +240,7 @@ void ObjectObserver::rosSpinner()
 {
   mc_rtc::log::info("[{}] rosSpinner started", name());
   RosRate rate(200);
-  while(ros_ok())
+  while(!stopSpinner_ && ros_ok())
   {
     spinOnce(nh_);
     rate.sleep();
@@ -229,6 +248,12 @@ void ObjectObserver::rosSpinner()
   mc_rtc::log::info("[{}] rosSpinner finished", name());
 }
 
+void ObjectObserver::stopSpinner()
+{
+  stopSpinner_ = true;
+  if(thread_.joinable()) { thread_.join(); }
+}
+
 } // namespace mc_state_observation
 
 EXPORT_OBSERVER_MODULE("Object", mc_state_observation::ObjectObserver)
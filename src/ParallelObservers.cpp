@@ -0,0 +1,249 @@
+#include <mc_control/MCController.h>
+#include <mc_observers/ObserverLoader.h>
+#include <mc_observers/ObserverMacros.h>
+#include <mc_state_observation/ParallelObservers.h>
+
+#include <fmt/ranges.h>
+
+#include <algorithm>
+
+namespace
+{
+/// Gives access to the logging and GUI functions of the child observers, that mc_observers only exposes to the
+/// observer pipelines.
+struct ObserverAccess : public mc_observers::Observer
+{
+  static void childAddToLogger(mc_observers::Observer & observer,
+                               const mc_control::MCController & ctl,
+                               mc_rtc::Logger & logger,
+                               const std::string & category)
+  {
+    (observer.*(&ObserverAccess::addToLogger))(ctl, logger, category);
+  }
+
+  static void childRemoveFromLogger(mc_observers::Observer & observer,
+                                    mc_rtc::Logger & logger,
+                                    const std::string & category)
+  {
+    (observer.*(&ObserverAccess::removeFromLogger))(logger, category);
+  }
+
+  static void childAddToGUI(mc_observers::Observer & observer,
+                            const mc_control::MCController & ctl,
+                            mc_rtc::gui::StateBuilder & gui,
+                            const std::vector<std::string> & category)
+  {
+    (observer.*(&ObserverAccess::addToGUI))(ctl, gui, category);
+  }
+};
+} // namespace
+
+namespace mc_state_observation
+{
+
+ParallelObservers::ParallelObservers(const std::string & type, double dt) : mc_observers::Observer(type, dt)
+{
+  runTiming_ = timer_.addStage("run");
+  runTask_ = [this](size_t i) { runChild(observers_[(*currentLevel_)[i]]); };
+}
+
+void ParallelObservers::runChild(ChildObserver & child)
+{
+  try
+  {
+    child.success = child.observer->run(*ctl_);
+  }
+  catch(...)
+  {
+    child.success = false;
+    child.exception = std::current_exception();
+  }
+}
+
+void ParallelObservers::configure(const mc_control::MCController & ctl, const mc_rtc::Configuration & config)
+{
+  if(!config.has("observers"))
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[{}] The list of observers to run is mandatory.", name());
+  }
+
+  // configuring the observer again replaces its children. The previous workers are joined before the new pool is
+  // created.
+  pool_.reset();
+  observers_.clear();
+  levels_.clear();
+  concurrentLevels_.clear();
+
+  size_t nbLevels = 0;
+  for(const auto & observerConfig : config("observers"))
+  {
+    const std::string type = observerConfig("type");
+    const std::string observerName = observerConfig("name", type);
+    for(const auto & child : observers_)
+    {
+      if(child.observer->name() == observerName)
+      {
+        mc_rtc::log::error_and_throw<std::runtime_error>("[{}] Two observers are named {}.", name(), observerName);
+      }
+    }
+
+    ChildObserver child;
+    child.observer = mc_observers::ObserverLoader::get_observer(type, dt());
+    child.observer->name(observerName);
+    observerConfig("update", child.update);
+    observerConfig("parallelSafe", child.parallelSafe);
+
+    // the dependencies must be declared before the observer, which also prevents dependency cycles
+    const std::vector<std::string> dependencies = observerConfig("dependsOn", std::vector<std::string>{});
+    for(const auto & dependency : dependencies)
+    {
+      auto it = std::find_if(observers_.begin(), observers_.end(),
+                             [&dependency](const ChildObserver & o) { return o.observer->name() == dependency; });
+      if(it == observers_.end())
+      {
+        mc_rtc::log::error_and_throw<std::runtime_error>(
+            "[{}] Observer {} depends on {}, which must be declared before it.", name(), observerName, dependency);
+      }
+      child.level = std::max(child.level, it->level + 1);
+    }
+    nbLevels = std::max(nbLevels, child.level + 1);
+
+    child.observer->configure(ctl, observerConfig("config", mc_rtc::Configuration{}));
+    observers_.push_back(child);
+  }
+
+  levels_.resize(nbLevels);
+  concurrentLevels_.resize(nbLevels);
+  size_t maxLevelSize = 0;
+  for(size_t i = 0; i < observers_.size(); i++)
+  {
+    const size_t level = observers_[i].level;
+    levels_[level].push_back(i);
+    if(observers_[i].parallelSafe)
+    {
+      concurrentLevels_[level].push_back(i);
+      maxLevelSize = std::max(maxLevelSize, concurrentLevels_[level].size());
+    }
+  }
+
+  // the control thread runs one observer of each level itself
+  size_t nbThreads = maxLevelSize > 0 ? maxLevelSize - 1 : 0;
+  config("threads", nbThreads);
+  std::vector<int> cpus = config("cpus", std::vector<int>{});
+  pool_.reset(new threadingTools::WorkerPool(nbThreads, cpus));
+
+  timer_.enabled(config("withTimings", false));
+
+  std::vector<std::string> levelsDesc;
+  for(const auto & level : levels_)
+  {
+    std::vector<std::string> names;
+    for(const auto & i : level)
+    {
+      const auto & child = observers_[i];
+      names.push_back(child.parallelSafe ? child.observer->name() : child.observer->name() + " (sequential)");
+    }
+    levelsDesc.push_back(fmt::format("[{}]", fmt::join(names, ", ")));
+  }
+  desc_ = fmt::format("{} ({}, threads: {})", name(), fmt::join(levelsDesc, " -> "), nbThreads);
+}
+
+void ParallelObservers::reset(const mc_control::MCController & ctl)
+{
+  for(auto & child : observers_)
+  {
+    child.observer->reset(ctl);
+    child.success = true;
+    child.exception = nullptr;
+  }
+}
+
+bool ParallelObservers::run(const mc_control::MCController & ctl)
+{
+  auto runTimer = timer_.scope(runTiming_);
+
+  bool success = true;
+  ctl_ = &ctl;
+  for(size_t l = 0; l < levels_.size(); l++)
+  {
+    const auto & level = levels_[l];
+    currentLevel_ = &concurrentLevels_[l];
+    pool_->parallelFor(currentLevel_->size(), runTask_);
+
+    // the observers that may write to shared data are run on the calling thread once the workers are done
+    for(const auto & i : level)
+    {
+      if(!observers_[i].parallelSafe) { runChild(observers_[i]); }
+    }
+
+    // the robots are updated in the order of the configuration once the whole level is estimated
+    for(const auto & i : level)
+    {
+      auto & child = observers_[i];
+      if(child.exception)
+      {
+        std::exception_ptr exception = child.exception;
+        child.exception = nullptr;
+        std::rethrow_exception(exception);
+      }
+      if(!child.success)
+      {
+        success = false;
+        continue;
+      }
+      if(child.update) { child.observer->update(const_cast<mc_control::MCController &>(ctl)); }
+    }
+  }
+
+  if(!success)
+  {
+    error_.clear();
+    for(const auto & child : observers_)
+    {
+      if(!child.success) { error_ += fmt::format("[{}] {}\n", child.observer->name(), child.observer->error()); }
+    }
+  }
+  return success;
+}
+
+void ParallelObservers::update(mc_control::MCController &)
+{
+  // the child observers update the robots within run(), as the next dependency levels rely on their estimation.
+}
+
+void ParallelObservers::addToLogger(const mc_control::MCController & ctl,
+                                    mc_rtc::Logger & logger,
+                                    const std::string & category)
+{
+  for(auto & child : observers_)
+  {
+    ObserverAccess::childAddToLogger(*child.observer, ctl, logger, category + "_" + child.observer->name());
+  }
+  timer_.addToLogger(logger, category);
+}
+
+void ParallelObservers::removeFromLogger(mc_rtc::Logger & logger, const std::string & category)
+{
+  for(auto & child : observers_)
+  {
+    ObserverAccess::childRemoveFromLogger(*child.observer, logger, category + "_" + child.observer->name());
+  }
+  timer_.removeFromLogger(logger, category);
+}
+
+void ParallelObservers::addToGUI(const mc_control::MCController & ctl,
+                                 mc_rtc::gui::StateBuilder & gui,
+                                 const std::vector<std::string> & category)
+{
+  for(auto & child : observers_)
+  {
+    std::vector<std::string> childCategory = category;
+    childCategory.push_back(child.observer->name());
+    ObserverAccess::childAddToGUI(*child.observer, ctl, gui, childCategory);
+  }
+  timer_.addToGUI(gui, category);
+}
+
+} // namespace mc_state_observation
+
+EXPORT_OBSERVER_MODULE("Parallel", mc_state_observation::ParallelObservers)
@@ -57,13 +57,23 @@ SLAMObserver::SLAMObserver(const std::string & type, double dt)
 : mc_observers::Observer(type, dt), nh_(mc_rtc::ROSBridge::get_node_handle())
 #ifdef MC_STATE_OBSERVATION_ROS_IS_ROS2
   ,
-  tfBuffer_(nh_->get_clock()), tfBroadcaster_(nh_)
+  tfBuffer_(nh_->get_clock()), tfStaticBroadcaster_(nh_)
 #endif
 {
+  runTiming_ = timer_.addStage("run");
+  updateTiming_ = timer_.addStage("update");
+}
+
+SLAMObserver::~SLAMObserver()
+{
+  stopSpinner();
 }
 
 void SLAMObserver::configure(const mc_control::MCController & ctl, const mc_rtc::Configuration & config)
 {
+  // the ROS thread reads the configuration
+  stopSpinner();
+
   if(config.has("Robot"))
   {
     robot_ = config("Robot")("robot", ctl.robot().name());
@@ -83,6 +93,7 @@ void SLAMObserver::configure(const mc_control::MCController & ctl, const mc_rtc:
     estimated_ = static_cast<std::string>(config("SLAM")("estimated"));
     if(config("SLAM").has("ground")) { ground_ = static_cast<std::string>(config("SLAM")("ground")); }
     config("SLAM")("initializeWithIdentity", isInitialized_);
+    X_0_Slam_changed_ = true;
   }
   else { mc_rtc::log::error_and_throw<std::runtime_error>("[{}] SLAM configuration is mandatory.", name()); }
 
@@ -97,6 +108,7 @@ void SLAMObserver::configure(const mc_control::MCController & ctl, const mc_rtc:
     n = config("Filter")("n", static_cast<int>(n));
   }
 
+  filterParams_ = Eigen::Vector3d(m, d, n);
   auto sg_conf = gram_sg::SavitzkyGolayFilterConfig(m, m, n, d);
   filter_.reset(new filter::Transform(sg_conf));
 
@@ -131,15 +143,20 @@ void SLAMObserver::configure(const mc_control::MCController & ctl, const mc_rtc:
 
   if(config.has("GUI")) { config("GUI")("plots", plotsEnabled_); }
 
+  timer_.enabled(config("withTimings", false));
+
   desc_ = fmt::format("{} (Camera: {}, Estimated: {}, inSimulation: {})", name(), camera_, estimated_, isSimulated_);
 
+  stopSpinner_ = false;
   thread_ = std::thread(std::bind(&SLAMObserver::rosSpinner, this));
+  if(config.has("thread")) { threadingTools::configureThread(thread_, config("thread"), name()); }
 }
 
 void SLAMObserver::reset(const mc_control::MCController &) {}
 
 bool SLAMObserver::run(const mc_control::MCController & ctl)
 {
+  auto runTimer = timer_.scope(runTiming_);
   isSLAMAlive_ = false;
 
   t_ += ctl.solver().dt();
@@ -175,12 +192,26 @@ bool SLAMObserver::run(const mc_control::MCController & ctl)
   }
   else
   {
-    // Connect SLAM and Robot map
-    auto transform = tf2::eigenToTransform(sva::conversions::toAffine(X_0_Slam_));
-    transform.header.stamp = RosTimeNow();
-    transform.header.frame_id = "robot_map";
-    transform.child_frame_id = map_;
-    tfBroadcaster_.sendTransform(transform);
+    if(cameraPoses_.consume())
+    {
+      const auto & cameraPose = cameraPoses_.front();
+      hasCameraPose_ = true;
+      isFilterReady_ = cameraPose.filtered;
+      if(cameraPose.filtered) { X_0_Filtered_estimated_camera_ = cameraPose.X_0_filtered_camera; }
+      filterDuration_ = cameraPose.filterDuration;
+    }
+
+    // Connect SLAM and Robot map. The transformation only changes on initialization, it is therefore broadcast as a
+    // static (latched) transformation when it changes instead of at every iteration.
+    if(X_0_Slam_changed_)
+    {
+      auto transform = tf2::eigenToTransform(sva::conversions::toAffine(X_0_Slam_));
+      transform.header.stamp = RosTimeNow();
+      transform.header.frame_id = "robot_map";
+      transform.child_frame_id = map_;
+      tfStaticBroadcaster_.sendTransform(transform);
+      X_0_Slam_changed_ = false;
+    }
 
     if(isSimulated_)
     {
@@ -195,15 +226,17 @@ bool SLAMObserver::run(const mc_control::MCController & ctl)
         X_0_Estimated_camera_ = apply(X_0_Estimated_camera_, minOrientationNoise_, maxOrientationNoise_,
                                       minTranslationNoise_, maxTranslationNoise_);
       }
+      // the simulated pose is filtered by the ROS thread, as the poses received from the SLAM
+      simulatedCameraPoses_.publish(X_0_Estimated_camera_);
     }
     else
     {
-      if(!getTransformStamped("robot_map", estimated_, transformStamped))
+      if(!hasCameraPose_)
       {
-        error_ = fmt::format("[{}] Could not get transform from \"{}\" to \"{}\"", name(), "robot_map", estimated_);
+        error_ = fmt::format("[{}] No transform from \"{}\" to \"{}\" received yet", name(), "robot_map", estimated_);
         return false;
       }
-      X_0_Estimated_camera_ = sva::conversions::fromHomogeneous(tf2::transformToEigen(transformStamped).matrix());
+      X_0_Estimated_camera_ = cameraPoses_.front().X_0_camera;
       if(!getTransformStamped("robot_map", ground_, transformStamped))
       {
         error_ = fmt::format("[{}] Could not get transform from \"{}\" to \"{}\"", name(), "robot_map", ground_);
@@ -216,6 +249,7 @@ bool SLAMObserver::run(const mc_control::MCController & ctl)
 
 void SLAMObserver::update(mc_control::MCController & ctl)
 {
+  auto updateTimer = timer_.scope(updateTiming_);
   if(!isInitialized_)
   {
     if(ctl.datastore().has("SLAM::Robot")) { ctl.datastore().remove("SLAM::Robot"); }
@@ -247,15 +281,8 @@ void SLAMObserver::update(mc_control::MCController & ctl)
   const sva::PTransformd X_Camera_Freeflyer = X_0_FF * X_0_Camera.inv();
 
   sva::PTransformd X_0_Estimated_Freeflyer = X_Camera_Freeflyer * X_0_Estimated_camera_;
-  if(isFiltered_)
-  {
-    filter_->add(X_0_Estimated_camera_);
-    if(filter_->ready())
-    {
-      X_0_Filtered_estimated_camera_ = filter_->filter();
-      X_0_Estimated_Freeflyer = X_Camera_Freeflyer * X_0_Filtered_estimated_camera_;
-    }
-  }
+  // the filtering is performed by the ROS thread on the reception of each pose
+  if(isFiltered_ && isFilterReady_) { X_0_Estimated_Freeflyer = X_Camera_Freeflyer * X_0_Filtered_estimated_camera_; }
 
   SLAM_robot.posW(X_0_Estimated_Freeflyer);
   SLAM_robot.forwardKinematics();
@@ -290,6 +317,11 @@ void SLAMObserver::addToLogger(const mc_control::MCController &, mc_rtc::Logger
                      { return (robots_->size() == 1 ? robots_->robot().posW() : sva::PTransformd::Identity()); });
   logger.addLogEntry(category + "_camera", [this]() { return X_0_Estimated_camera_; });
   logger.addLogEntry(category + "_cameraFiltered", [this]() { return X_0_Filtered_estimated_camera_; });
+  timer_.addToLogger(logger, category);
+  if(timer_.enabled())
+  {
+    logger.addLogEntry(category + "_timings_filter", [this]() { return filterDuration_; });
+  }
 }
 
 void SLAMObserver::removeFromLogger(mc_rtc::Logger & logger, const std::string & category)
@@ -303,6 +335,8 @@ void SLAMObserver::removeFromLogger(mc_rtc::Logger & logger, const std::string &
   logger.removeLogEntry(category + "_posW");
   logger.removeLogEntry(category + "_camera");
   logger.removeLogEntry(category + "_cameraFiltered");
+  timer_.removeFromLogger(logger, category);
+  logger.removeLogEntry(category + "_timings_filter");
 }
 
 void SLAMObserver::addToGUI(const mc_control::MCController & ctl,
@@ -319,7 +353,10 @@ void SLAMObserver::addToGUI(const mc_control::MCController & ctl,
                                          const auto & real_robot = ctl.realRobot(robot_);
                                          const auto & X_0_Camera = real_robot.bodyPosW(camera_);
                                          X_0_Slam_ = X_Slam_Estimated_Camera_.inv() * X_0_Camera;
-                                         filter_->reset();
+                                         X_0_Slam_changed_ = true;
+                                         hasCameraPose_ = false;
+                                         isFilterReady_ = false;
+                                         resetFilter_ = true;
                                        }
                                      }),
                  mc_rtc::gui::Transform("X_0_Slam", [this]() { return X_0_Slam_; }),
@@ -344,21 +381,22 @@ void SLAMObserver::addToGUI(const mc_control::MCController & ctl,
                                      [this]()
                                      {
                                        isFiltered_ = !isFiltered_;
-                                       if(isFiltered_) { filter_->reset(); }
+                                       if(isFiltered_)
+                                       {
+                                         isFilterReady_ = false;
+                                         resetFilter_ = true;
+                                       }
                                      }),
                  mc_rtc::gui::Label("Apply filter:", [this]() { return (isFiltered_ ? "yes" : "no"); }),
                  mc_rtc::gui::ArrayInput(
                      "Filter config", {"m", "d", "n"},
-                     [this]()
-                     { return Eigen::Vector3d(filter_->config().m, filter_->config().s, filter_->config().n); },
+                     [this]() { return filterParams_; },
                      [this](const Eigen::Vector3d & v)
                      {
-                       int m = static_cast<int>(v.x());
-                       int d = static_cast<int>(v.y());
-                       int n = static_cast<int>(v.z());
-                       auto sg_conf = gram_sg::SavitzkyGolayFilterConfig(m, m, n, d);
-                       filter_.reset(new filter::Transform(sg_conf));
-                       filter_->reset();
+                       // the filter is rebuilt by the ROS thread
+                       filterParams_ = v;
+                       isFilterReady_ = false;
+                       newFilterParams_.publish(v);
                      }));
 
   if(isSimulated_)
@@ -401,6 +439,8 @@ void SLAMObserver::addToGUI(const mc_control::MCController & ctl,
                        }));
   }
 
+  timer_.addToGUI(gui, category);
+
   if(plotsEnabled_) { addPlots(gui); }
 }
 
@@ -492,14 +532,82 @@ void SLAMObserver::rosSpinner()
 {
   mc_rtc::log::info("[{}] rosSpinner started", name());
   RosRate rate(30);
-  while(ros_ok())
+  decltype(TransformStamped::header.stamp) lastStamp;
+  while(!stopSpinner_ && ros_ok())
   {
     spinOnce(nh_);
+    sva::PTransformd X_0_Camera;
+    if(receiveCameraPose(X_0_Camera, lastStamp)) { filterCameraPose(X_0_Camera); }
     rate.sleep();
   }
   mc_rtc::log::info("[{}] rosSpinner finished", name());
 }
 
+void SLAMObserver::stopSpinner()
+{
+  stopSpinner_ = true;
+  if(thread_.joinable()) { thread_.join(); }
+}
+
+bool SLAMObserver::receiveCameraPose(sva::PTransformd & X_0_Camera,
+                                     decltype(TransformStamped::header.stamp) & lastStamp)
+{
+  if(isSimulated_)
+  {
+    if(!simulatedCameraPoses_.consume()) { return false; }
+    X_0_Camera = simulatedCameraPoses_.front();
+    return true;
+  }
+
+  TransformStamped transformStamped;
+  try
+  {
+    transformStamped = tfBuffer_.lookupTransform("robot_map", estimated_, RosTime(0));
+  }
+  catch(tf2::TransformException &)
+  {
+    return false;
+  }
+  // the SLAM runs slower than the ROS thread, the same pose is only filtered once
+  if(transformStamped.header.stamp == lastStamp) { return false; }
+  lastStamp = transformStamped.header.stamp;
+  X_0_Camera = sva::conversions::fromHomogeneous(tf2::transformToEigen(transformStamped).matrix());
+  return true;
+}
+
+void SLAMObserver::filterCameraPose(const sva::PTransformd & X_0_Camera)
+{
+  const auto start = timingTools::ExecutionTimer::Clock::now();
+
+  if(newFilterParams_.consume())
+  {
+    const Eigen::Vector3d & params = newFilterParams_.front();
+    int m = static_cast<int>(params.x());
+    int d = static_cast<int>(params.y());
+    int n = static_cast<int>(params.z());
+    auto sg_conf = gram_sg::SavitzkyGolayFilterConfig(m, m, n, d);
+    filter_.reset(new filter::Transform(sg_conf));
+    filter_->reset();
+  }
+  if(resetFilter_.exchange(false)) { filter_->reset(); }
+
+  auto & cameraPose = cameraPoses_.back();
+  cameraPose.X_0_camera = X_0_Camera;
+  cameraPose.filtered = false;
+  if(isFiltered_)
+  {
+    filter_->add(X_0_Camera);
+    if(filter_->ready())
+    {
+      cameraPose.X_0_filtered_camera = filter_->filter();
+      cameraPose.filtered = true;
+    }
+  }
+  cameraPose.filterDuration =
+      std::chrono::duration<double, std::milli>(timingTools::ExecutionTimer::Clock::now() - start).count();
+  cameraPoses_.publish();
+}
+
 } // namespace mc_state_observation
 
 EXPORT_OBSERVER_MODULE("SLAM", mc_state_observation::SLAMObserver)
@@ -16,6 +16,10 @@ TiltObserver::TiltObserver(const std::string & type, double dt)
   xk_.resize(9);
   xk_ << so::Vector3::Zero(), so::Vector3::Zero(), so::Vector3(0, 0, 1); // so::Vector3(0.49198, 0.66976, 0.55622);
   estimator_.setState(xk_, 0);
+
+  runTiming_ = timer_.addStage("run");
+  estimatorTiming_ = timer_.addStage("runTiltEstimator");
+  updateTiming_ = timer_.addStage("update");
 }
 
 void TiltObserver::configure(const mc_control::MCController & ctl, const mc_rtc::Configuration & config)
@@ -24,6 +28,10 @@ void TiltObserver::configure(const mc_control::MCController & ctl, const mc_rtc:
 
   imuSensor_ = config("imuSensor", ctl.robot().bodySensor().name());
 
+  timer_.enabled(config("withTimings", false));
+  displayRobot_.configure(config("guiRate", 30.), ctl.timeStep);
+  if(config.has("capture")) { inputsCapture_.configure(config("capture"), observerName_, ctl.robot(robot_)); }
+
   config("maxAnchorFrameDiscontinuity", maxAnchorFrameDiscontinuity_);
   config("updateRobot", updateRobot_);
   config("updateSensor", updateSensor_);
@@ -131,6 +139,13 @@ void TiltObserver::configure(const mc_control::MCController & ctl, const mc_rtc:
       odometryManager_.initDetection(ctl, robot_, contactsDetectionMethod, contactsSensorsDisabledInit,
                                      contactDetectionThreshold_, forceSensorsToOmit);
     }
+
+    // the odometry uses the replayed measurements instead of the ones of the controller
+    if(inputsCapture_.mode() == captureTools::InputsCapture::Mode::replay)
+    {
+      odometryManager_.setInputRobots(&inputsCapture_.robot(ctl.robot(robot_)),
+                                      &inputsCapture_.realRobot(ctl.realRobot(robot_)));
+    }
   }
 
   // check if this observer is used as a backup. If yes we add the backup function to the datastore.
@@ -156,14 +171,11 @@ void TiltObserver::reset(const mc_control::MCController & ctl)
   const auto & realRobot = ctl.realRobot(robot_);
 
   my_robots_ = mc_rbdyn::Robots::make();
-  my_robots_->robotCopy(robot, robot.name());
 
   // the updated robot has the same floating base's pose than the control robot, but its encoders are updated. We use it
   // to get more accurate local Kinematics.
   my_robots_->robotCopy(robot, "updatedRobot");
-  ctl.gui()->addElement(
-      {"Robots"},
-      mc_rtc::gui::Robot("TiltEstimator", [this]() -> const mc_rbdyn::Robot & { return my_robots_->robot(); }));
+  displayRobot_.reset(*ctl.gui(), {"Robots"}, "TiltEstimator", robot);
   /*
 ctl.gui()->addElement(
   {"Robots"},
@@ -211,16 +223,26 @@ my_robots_->robot("updatedRobot"); }));
     int backupIterInterval = ctl.datastore().get<int>("koBackupIterInterval");
 
     backupFbKinematics_.resize(backupIterInterval);
+    ctl.gui()->removeElement({"OdometryBackup"}, "OdometryBackup");
     ctl.gui()->addElement({"OdometryBackup"}, mc_rtc::gui::Button("OdometryBackup", [this, &ctl]() { backupFb(ctl); }));
   }
 }
 
 bool TiltObserver::run(const mc_control::MCController & ctl)
 {
-  const auto & robot = ctl.robot(robot_);
-  const auto & realRobot = ctl.realRobot(robot_);
+  auto runTimer = timer_.scope(runTiming_);
   auto & logger = (const_cast<mc_control::MCController &>(ctl)).logger();
 
+  // records the inputs of the iteration, or replays the captured ones into the robots of the capture
+  if(!inputsCapture_.process(logger.t(), ctl.robot(robot_), ctl.realRobot(robot_)))
+  {
+    error_ = fmt::format("[{}] End of the replayed capture", observerName_);
+    return false;
+  }
+
+  const auto & robot = inputsCapture_.robot(ctl.robot(robot_));
+  const auto & realRobot = inputsCapture_.realRobot(ctl.realRobot(robot_));
+
   std::vector<double> q0 = robot.mbc().q[0];
   my_robots_->robot("updatedRobot").mbc().q = realRobot.mbc().q;
   my_robots_->robot("updatedRobot").mbc().q[0] = q0;
@@ -235,14 +257,20 @@ bool TiltObserver::run(const mc_control::MCController & ctl)
     gamma_ = finalGamma_;
   }
 
+  timer_.start(estimatorTiming_);
   if(odometryManager_.odometryType_ == measurements::None) { runTiltEstimator(ctl, my_robots_->robot("updatedRobot")); }
   else { runTiltEstimator(ctl, odometryManager_.odometryRobot()); }
+  timer_.stop(estimatorTiming_);
+
+  if(odometryManager_.odometryType_ != measurements::None)
+  {
+    inputsCapture_.contacts(odometryManager_.contactsManager().contactsFound());
+  }
 
   iter_++;
 
-  /* Update of the observed robot */
-  my_robots_->robot().mbc().q = realRobot.mbc().q;
-  update(my_robots_->robot());
+  /* Update of the visual representation (only a visual feature) of the observed robot */
+  displayRobot_.update(realRobot, [this](mc_rbdyn::Robot & displayed) { update(displayed); });
 
   return true;
 }
@@ -320,7 +348,7 @@ void TiltObserver::updateAnchorFrameOdometry(const mc_control::MCController & ct
 void TiltObserver::updateAnchorFrameNoOdometry(const mc_control::MCController & ctl,
                                                const mc_rbdyn::Robot & updatedRobot)
 {
-  const auto & robot = ctl.robot(robot_);
+  const auto & robot = inputsCapture_.robot(ctl.robot(robot_));
   // const auto & robot = my_robots_->robot("updatedRobot");
 
   anchorFrameJumped_ = false;
@@ -352,7 +380,7 @@ void TiltObserver::runTiltEstimator(const mc_control::MCController & ctl, const
   For internal kinematics like the anchor frame in the IMU, we use the updated robot whose encoders got updated.
   */
   // const auto & robot = my_robots_->robot("updatedRobot");
-  const auto & robot = ctl.robot(robot_);
+  const auto & robot = inputsCapture_.robot(ctl.robot(robot_));
 
   estimator_.setAlpha(alpha_);
   estimator_.setBeta(beta_);
@@ -372,7 +400,7 @@ void TiltObserver::runTiltEstimator(const mc_control::MCController & ctl, const
   // - angular velocity of the imu
   // - linear velocity of the anchor frame in the world of the control robot (derivative?)
 
-  const auto & imu = ctl.robot(robot_).bodySensor(imuSensor_);
+  const auto & imu = robot.bodySensor(imuSensor_);
   // const auto & rimu = updatedRobot.bodySensor(imuSensor_);
 
   // In the case we do odometry, the pose and velocities of the odometry robot are still not updated but the joints are.
@@ -555,6 +583,7 @@ void TiltObserver::updatePoseAndVel(const so::Vector3 & localWorldImuLinVel, con
 
 void TiltObserver::update(mc_control::MCController & ctl)
 {
+  auto updateTimer = timer_.scope(updateTiming_);
   auto & realRobot = ctl.realRobot(robot_);
   if(updateRobot_)
   {
@@ -598,16 +627,20 @@ const so::kine::Kinematics TiltObserver::backupFb(const mc_control::MCController
   so::kine::Kinematics fbWorldInitBackup = worldFbInitBackup.getInverse();
 
   // we apply the transformation from the initial pose to the intermediates pose estimated by the tilt estimator to the
-  // new starting pose of the Kinetics Observer
-  for(int i = 0; i < koBackupFbKinematics->size(); i++)
+  // new starting pose of the Kinetics Observer: worldReset * (fbWorldInit * worldFbInterm), computed for the whole
+  // interval at once
+  const so::kine::Kinematics worldResetFbWorldInit = worldResetKine * fbWorldInitBackup;
+  const auto nbBackupPoses = static_cast<Eigen::Index>(koBackupFbKinematics->size());
+  backupPoses_.resize(nbBackupPoses);
+  for(Eigen::Index i = 0; i < nbBackupPoses; i++)
   {
     // Intermediary pose of the floating base estimated by the tilt estimator
-    so::kine::Kinematics worldFbIntermBackup =
-        kinematicsTools::poseFromSva(backupFbKinematics_.at(i), so::kine::Kinematics::Flags::pose);
-    // transformation between the initial and the intermediary pose during the backup interval
-    so::kine::Kinematics initInterm = fbWorldInitBackup * worldFbIntermBackup;
-
-    koBackupFbKinematics->at(i) = worldResetKine * initInterm;
+    backupPoses_.set(i, backupFbKinematics_.at(static_cast<size_t>(i)));
+  }
+  kinematicsTools::compose(worldResetFbWorldInit, backupPoses_, transferredBackupPoses_);
+  for(Eigen::Index i = 0; i < nbBackupPoses; i++)
+  {
+    koBackupFbKinematics->at(static_cast<size_t>(i)) = transferredBackupPoses_.kinematics(i);
   }
 
   so::Vector3 tiltLocalLinVel = poseW_.rotation() * velW_.linear();
@@ -917,6 +950,8 @@ void TiltObserver::addToLogger(const mc_control::MCController & ctl,
 
   kinematicsTools::addToLogger(updatedWorldFbKine_, logger, category + "_debug_updatedWorldFbKine_");
   kinematicsTools::addToLogger(correctedWorldImuKine_, logger, category + "_debug_correctedWorldImuKine_");
+
+  timer_.addToLogger(logger, category);
 }
 
 void TiltObserver::removeFromLogger(mc_rtc::Logger & logger, const std::string & category)
@@ -925,6 +960,7 @@ void TiltObserver::removeFromLogger(mc_rtc::Logger & logger, const std::string &
   logger.removeLogEntry(category + "_imuPoseC");
   logger.removeLogEntry(category + "_imuEstRotW");
   logger.removeLogEntry(category + "_controlAnchorFrame");
+  timer_.removeFromLogger(logger, category);
 }
 
 void TiltObserver::addToGUI(const mc_control::MCController &,
@@ -934,6 +970,7 @@ void TiltObserver::addToGUI(const mc_control::MCController &,
   using namespace mc_state_observation::gui;
   gui.addElement(category, make_input_element("alpha", alpha_), make_input_element("beta", beta_),
                  make_input_element("gamma", gamma_));
+  timer_.addToGUI(gui, category);
 
   if(odometryManager_.odometryType_ != measurements::None)
   {
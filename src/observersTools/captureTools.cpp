@@ -0,0 +1,319 @@
+#include <mc_rtc/logging.h>
+#include <mc_state_observation/observersTools/captureTools.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace mc_state_observation
+{
+namespace captureTools
+{
+
+namespace
+{
+constexpr char magicNumber[8] = {'M', 'C', 'S', 'O', 'C', 'A', 'P', '2'};
+
+uint64_t flattenedSize(const std::vector<std::vector<double>> & values)
+{
+  uint64_t size = 0;
+  for(const auto & v : values) { size += v.size(); }
+  return size;
+}
+
+inline void write(double *& out, const std::vector<std::vector<double>> & values)
+{
+  for(const auto & v : values)
+  {
+    std::memcpy(out, v.data(), v.size() * sizeof(double));
+    out += v.size();
+  }
+}
+
+inline void write(double *& out, const Eigen::Vector3d & value)
+{
+  std::memcpy(out, value.data(), 3 * sizeof(double));
+  out += 3;
+}
+
+inline void read(const double *& in, std::vector<std::vector<double>> & values)
+{
+  for(auto & v : values)
+  {
+    std::memcpy(v.data(), in, v.size() * sizeof(double));
+    in += v.size();
+  }
+}
+
+inline Eigen::Vector3d read(const double *& in)
+{
+  Eigen::Vector3d value;
+  std::memcpy(value.data(), in, 3 * sizeof(double));
+  in += 3;
+  return value;
+}
+} // namespace
+
+InputsCapture::~InputsCapture()
+{
+  close();
+}
+
+void InputsCapture::configure(const mc_rtc::Configuration & config,
+                              const std::string & observerName,
+                              const mc_rbdyn::Robot & robot)
+{
+  close();
+  observerName_ = observerName;
+
+  const std::string mode = config("mode", std::string("none"));
+  if(mode == "none") { return; }
+  if(mode != "record" && mode != "replay")
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>(
+        "[{}] Capture mode {} not allowed. Please pick among : [none, record, replay]", observerName_, mode);
+  }
+  const std::string path = config("path");
+
+  CaptureHeader layout;
+  std::memcpy(layout.magic, magicNumber, sizeof(magicNumber));
+  layout.nq = flattenedSize(robot.mbc().q);
+  layout.ndof = flattenedSize(robot.mbc().alpha);
+  layout.nbBodySensors = robot.bodySensors().size();
+  layout.nbForceSensors = robot.forceSensors().size();
+  layout.frameSize = sizeof(CaptureFrameHeader)
+                     + (2 * layout.nq + 3 * layout.ndof + 6 * layout.nbBodySensors + 6 * layout.nbForceSensors)
+                           * sizeof(double);
+
+  if(mode == "record")
+  {
+    mode_ = Mode::record;
+    layout.capacity = static_cast<uint64_t>(config("frames", 60000));
+    layout.nbWritten = 0;
+    if(layout.capacity == 0)
+    {
+      mc_rtc::log::error_and_throw<std::runtime_error>("[{}] The capture must contain at least one frame",
+                                                       observerName);
+    }
+
+    mappedSize_ = sizeof(CaptureHeader) + layout.capacity * layout.frameSize;
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(fd_ < 0 || ::ftruncate(fd_, static_cast<off_t>(mappedSize_)) != 0)
+    {
+      close();
+      mc_rtc::log::error_and_throw<std::runtime_error>("[{}] Could not create the capture file {}: {}",
+                                                       observerName, path, std::strerror(errno));
+    }
+    mapping_ = ::mmap(nullptr, mappedSize_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+  }
+  else
+  {
+    mode_ = Mode::replay;
+    struct stat fileStat;
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if(fd_ < 0 || ::fstat(fd_, &fileStat) != 0 || static_cast<size_t>(fileStat.st_size) < sizeof(CaptureHeader))
+    {
+      close();
+      mc_rtc::log::error_and_throw<std::runtime_error>("[{}] Could not open the capture file {}", observerName, path);
+    }
+    mappedSize_ = static_cast<size_t>(fileStat.st_size);
+    mapping_ = ::mmap(nullptr, mappedSize_, PROT_READ, MAP_SHARED, fd_, 0);
+  }
+
+  if(mapping_ == MAP_FAILED)
+  {
+    mapping_ = nullptr;
+    close();
+    mc_rtc::log::error_and_throw<std::runtime_error>("[{}] Could not map the capture file {} in memory", observerName,
+                                                     path);
+  }
+  header_ = static_cast<CaptureHeader *>(mapping_);
+  data_ = static_cast<char *>(mapping_) + sizeof(CaptureHeader);
+
+  if(mode_ == Mode::record)
+  {
+    // writing the whole file now allocates its blocks and avoids page faults in the control loop
+    std::memset(mapping_, 0, mappedSize_);
+    *header_ = layout;
+    return;
+  }
+
+  if(std::memcmp(header_->magic, magicNumber, sizeof(magicNumber)) != 0 || header_->frameSize != layout.frameSize
+     || header_->nq != layout.nq || header_->ndof != layout.ndof || header_->nbBodySensors != layout.nbBodySensors
+     || header_->nbForceSensors != layout.nbForceSensors || header_->capacity == 0
+     || mappedSize_ < sizeof(CaptureHeader) + header_->capacity * header_->frameSize)
+  {
+    close();
+    mc_rtc::log::error_and_throw<std::runtime_error>("[{}] The capture file {} does not match the robot {}",
+                                                     observerName, path, robot.name());
+  }
+  nbFrames_ = std::min(header_->nbWritten, header_->capacity);
+  // the ring contains the last frames only
+  nextFrame_ = header_->nbWritten - nbFrames_;
+  contactsMismatchReported_ = false;
+
+  // the real robot shares the sensors of the control robot, as in the controller
+  replayRobots_ = mc_rbdyn::loadRobot(robot.module());
+  replayRobots_->robotCopy(replayRobots_->robot(0), "replayRealRobot");
+  mc_rtc::log::info("[{}] Replaying {} frames from {}", observerName, nbFrames_, path);
+}
+
+bool InputsCapture::process(double time, const mc_rbdyn::Robot & robot, const mc_rbdyn::Robot & realRobot)
+{
+  switch(mode_)
+  {
+    case Mode::none:
+      return true;
+    case Mode::record:
+      currentFrame_ = frame(header_->nbWritten);
+      record(currentFrame_, time, robot, realRobot);
+      header_->nbWritten++;
+      return true;
+    case Mode::replay:
+      if(nextFrame_ >= header_->nbWritten) { return false; }
+      currentFrame_ = frame(nextFrame_++);
+      replay(currentFrame_, replayRobots_->robot(0), replayRobots_->robot(1));
+      return true;
+  }
+  return true;
+}
+
+bool InputsCapture::contacts(const std::set<int> & contacts)
+{
+  if(currentFrame_ == nullptr) { return true; }
+  uint64_t bits = 0;
+  for(const int & contact : contacts)
+  {
+    if(contact >= 0 && contact < 64) { bits |= uint64_t(1) << contact; }
+  }
+  auto * frameHeader = reinterpret_cast<CaptureFrameHeader *>(currentFrame_);
+  if(mode_ == Mode::record)
+  {
+    frameHeader->contacts = bits;
+    return true;
+  }
+  if(frameHeader->contacts == bits) { return true; }
+  if(!contactsMismatchReported_)
+  {
+    mc_rtc::log::warning("[{}] The detected contacts differ from the captured ones from the frame {} (time {}). The "
+                         "next differences will not be reported.",
+                         observerName_, frameHeader->iteration, frameHeader->time);
+    contactsMismatchReported_ = true;
+  }
+  return false;
+}
+
+void InputsCapture::record(char * frame, double time, const mc_rbdyn::Robot & robot, const mc_rbdyn::Robot & realRobot)
+{
+  auto * frameHeader = reinterpret_cast<CaptureFrameHeader *>(frame);
+  frameHeader->iteration = header_->nbWritten;
+  frameHeader->time = time;
+  frameHeader->timestamp =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+          .count();
+  frameHeader->contacts = 0;
+
+  auto * values = reinterpret_cast<double *>(frame + sizeof(CaptureFrameHeader));
+  write(values, realRobot.mbc().q);
+  write(values, robot.mbc().q);
+  write(values, realRobot.mbc().alpha);
+  write(values, realRobot.mbc().alphaD);
+  write(values, robot.mbc().alpha);
+  for(const auto & sensor : robot.bodySensors())
+  {
+    write(values, sensor.linearAcceleration());
+    write(values, sensor.angularVelocity());
+  }
+  for(const auto & sensor : robot.forceSensors())
+  {
+    write(values, sensor.wrench().couple());
+    write(values, sensor.wrench().force());
+  }
+}
+
+void InputsCapture::replay(const char * frame, mc_rbdyn::Robot & robot, mc_rbdyn::Robot & realRobot)
+{
+  const auto * values = reinterpret_cast<const double *>(frame + sizeof(CaptureFrameHeader));
+  read(values, realRobot.mbc().q);
+  read(values, robot.mbc().q);
+  read(values, realRobot.mbc().alpha);
+  read(values, realRobot.mbc().alphaD);
+  read(values, robot.mbc().alpha);
+
+  // the sensors are shared by the control and the real robots
+  auto & data = *robot.data();
+  for(auto & sensor : data.bodySensors)
+  {
+    sensor.linearAcceleration(read(values));
+    sensor.angularVelocity(read(values));
+  }
+  for(auto & sensor : data.forceSensors)
+  {
+    const Eigen::Vector3d couple = read(values);
+    const Eigen::Vector3d force = read(values);
+    sensor.wrench(sva::ForceVecd(couple, force));
+  }
+
+  robot.forwardKinematics();
+  robot.forwardVelocity();
+  realRobot.forwardKinematics();
+  realRobot.forwardVelocity();
+  realRobot.forwardAcceleration();
+}
+
+void InputsCapture::close()
+{
+  if(mapping_ != nullptr)
+  {
+    ::munmap(mapping_, mappedSize_);
+    mapping_ = nullptr;
+  }
+  if(fd_ >= 0)
+  {
+    ::close(fd_);
+    fd_ = -1;
+  }
+  header_ = nullptr;
+  data_ = nullptr;
+  currentFrame_ = nullptr;
+  nbFrames_ = 0;
+  nextFrame_ = 0;
+  mode_ = Mode::none;
+  replayRobots_.reset();
+}
+
+std::vector<double> readFramesTime(const std::string & path)
+{
+  std::ifstream file(path, std::ios::binary);
+  CaptureHeader header;
+  if(!file.read(reinterpret_cast<char *>(&header), sizeof(CaptureHeader))
+     || std::memcmp(header.magic, magicNumber, sizeof(magicNumber)) != 0 || header.capacity == 0)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("Could not read the capture file {}", path);
+  }
+
+  const uint64_t nbFrames = std::min(header.nbWritten, header.capacity);
+  const uint64_t firstFrame = header.nbWritten - nbFrames;
+  std::vector<double> times(nbFrames);
+  for(uint64_t i = 0; i < nbFrames; i++)
+  {
+    const uint64_t offset = sizeof(CaptureHeader) + ((firstFrame + i) % header.capacity) * header.frameSize
+                            + offsetof(CaptureFrameHeader, time);
+    file.seekg(static_cast<std::streamoff>(offset));
+    if(!file.read(reinterpret_cast<char *>(&times[i]), sizeof(double)))
+    {
+      mc_rtc::log::error_and_throw<std::runtime_error>("The capture file {} is truncated", path);
+    }
+  }
+  return times;
+}
+
+} // namespace captureTools
+} // namespace mc_state_observation
@@ -1,5 +1,9 @@
 #include <mc_state_observation/observersTools/kinematicsTools.h>
 
+#include <cassert>
+#include <limits>
+#include <memory>
+
 namespace so = stateObservation;
 
 namespace mc_state_observation
@@ -124,44 +128,57 @@ so::kine::Kinematics & addVelsAndAccs(so::kine::Kinematics & kine,
   return kine;
 }
 
+namespace
+{
+/// Values of a Kinematics object written in the log, computed once per logged iteration. The variables that are not set
+/// are logged as zero.
+struct KinematicsLogRecord
+{
+  const KinematicsLogRecord & update(const so::kine::Kinematics & kine, double t)
+  {
+    if(t == time) { return *this; }
+    time = t;
+    if(kine.position.isSet()) { position = kine.position(); }
+    else { position.setZero(); }
+    if(kine.orientation.isSet()) { orientation = kine.orientation.inverse().toQuaternion(); }
+    else { orientation.setIdentity(); }
+    if(kine.linVel.isSet()) { linVel = kine.linVel(); }
+    else { linVel.setZero(); }
+    if(kine.angVel.isSet()) { angVel = kine.angVel(); }
+    else { angVel.setZero(); }
+    if(kine.linAcc.isSet()) { linAcc = kine.linAcc(); }
+    else { linAcc.setZero(); }
+    if(kine.angAcc.isSet()) { angAcc = kine.angAcc(); }
+    else { angAcc.setZero(); }
+    return *this;
+  }
+
+  double time = std::numeric_limits<double>::quiet_NaN(); // time of the logger at the last update
+  so::Vector3 position = so::Vector3::Zero();
+  Eigen::Quaterniond orientation = Eigen::Quaterniond::Identity();
+  so::Vector3 linVel = so::Vector3::Zero();
+  so::Vector3 angVel = so::Vector3::Zero();
+  so::Vector3 linAcc = so::Vector3::Zero();
+  so::Vector3 angAcc = so::Vector3::Zero();
+};
+} // namespace
+
 void addToLogger(const stateObservation::kine::Kinematics & kine, mc_rtc::Logger & logger, const std::string & prefix)
 {
-  logger.addLogEntry(prefix + "_position",
-                     [&kine]() -> const stateObservation::Vector3
-                     {
-                       if(kine.position.isSet()) { return kine.position(); }
-                       else { return stateObservation::Vector3::Zero(); }
-                     });
-  logger.addLogEntry(prefix + "_ori",
-                     [&kine]() -> Eigen::Quaterniond
-                     {
-                       if(kine.orientation.isSet()) { return kine.orientation.inverse().toQuaternion(); }
-                       else { return stateObservation::kine::Orientation::zeroRotation().toQuaternion(); }
-                     });
-  logger.addLogEntry(prefix + "_linVel",
-                     [&kine]() -> const stateObservation::Vector3
-                     {
-                       if(kine.linVel.isSet()) { return kine.linVel(); }
-                       else { return stateObservation::Vector3::Zero(); };
-                     });
-  logger.addLogEntry(prefix + "_angVel",
-                     [&kine]() -> const stateObservation::Vector3
-                     {
-                       if(kine.angVel.isSet()) { return kine.angVel(); }
-                       else { return stateObservation::Vector3::Zero(); };
-                     });
-  logger.addLogEntry(prefix + "_linAcc",
-                     [&kine]() -> const stateObservation::Vector3
-                     {
-                       if(kine.linAcc.isSet()) { return kine.linAcc(); }
-                       else { return stateObservation::Vector3::Zero(); };
-                     });
-  logger.addLogEntry(prefix + "_angAcc",
-                     [&kine]() -> const stateObservation::Vector3
-                     {
-                       if(kine.angAcc.isSet()) { return kine.angAcc(); }
-                       else { return stateObservation::Vector3::Zero(); };
-                     });
+  // the entries share a record updated by the first of them called on each logged iteration
+  auto record = std::make_shared<KinematicsLogRecord>();
+  logger.addLogEntry(prefix + "_position", [&kine, &logger, record]() -> const so::Vector3 &
+                     { return record->update(kine, logger.t()).position; });
+  logger.addLogEntry(prefix + "_ori", [&kine, &logger, record]() -> const Eigen::Quaterniond &
+                     { return record->update(kine, logger.t()).orientation; });
+  logger.addLogEntry(prefix + "_linVel", [&kine, &logger, record]() -> const so::Vector3 &
+                     { return record->update(kine, logger.t()).linVel; });
+  logger.addLogEntry(prefix + "_angVel", [&kine, &logger, record]() -> const so::Vector3 &
+                     { return record->update(kine, logger.t()).angVel; });
+  logger.addLogEntry(prefix + "_linAcc", [&kine, &logger, record]() -> const so::Vector3 &
+                     { return record->update(kine, logger.t()).linAcc; });
+  logger.addLogEntry(prefix + "_angAcc", [&kine, &logger, record]() -> const so::Vector3 &
+                     { return record->update(kine, logger.t()).angAcc; });
 }
 
 void removeFromLogger(mc_rtc::Logger & logger, const std::string & prefix)
@@ -186,5 +203,71 @@ sva::PTransformd pTransformFromKinematics(const so::kine::Kinematics & kine)
   return pose;
 }
 
+///////////////////////////////////////////////////////////////////////
+/// ---------------------------Batched poses---------------------------
+///////////////////////////////////////////////////////////////////////
+
+void PoseArray::resize(Eigen::Index size)
+{
+  orientations.resize(Eigen::NoChange, size);
+  positions.resize(Eigen::NoChange, size);
+}
+
+void PoseArray::set(Eigen::Index i, const so::Matrix3 & orientation, const so::Vector3 & position)
+{
+  for(Eigen::Index r = 0; r < 3; r++)
+  {
+    for(Eigen::Index c = 0; c < 3; c++) { orientations(3 * r + c, i) = orientation(r, c); }
+  }
+  positions.col(i) = position;
+}
+
+void PoseArray::set(Eigen::Index i, const so::kine::Kinematics & kine)
+{
+  set(i, kine.orientation.toMatrix3(), kine.position());
+}
+
+so::Matrix3 PoseArray::orientation(Eigen::Index i) const
+{
+  so::Matrix3 orientation;
+  for(Eigen::Index r = 0; r < 3; r++)
+  {
+    for(Eigen::Index c = 0; c < 3; c++) { orientation(r, c) = orientations(3 * r + c, i); }
+  }
+  return orientation;
+}
+
+so::Vector3 PoseArray::position(Eigen::Index i) const
+{
+  return positions.col(i);
+}
+
+so::kine::Kinematics PoseArray::kinematics(Eigen::Index i) const
+{
+  so::kine::Kinematics kine;
+  kine.position = position(i);
+  kine.orientation = orientation(i);
+  return kine;
+}
+
+void compose(const so::kine::Kinematics & a, const PoseArray & b, PoseArray & out)
+{
+  assert(&out != &b);
+  const so::Matrix3 & Ra = a.orientation.toMatrix3();
+  const so::Vector3 & pa = a.position();
+  out.resize(b.size());
+  for(Eigen::Index r = 0; r < 3; r++)
+  {
+    for(Eigen::Index c = 0; c < 3; c++)
+    {
+      out.orientations.row(3 * r + c) = Ra(r, 0) * b.orientations.row(c) + Ra(r, 1) * b.orientations.row(3 + c)
+                                        + Ra(r, 2) * b.orientations.row(6 + c);
+    }
+    out.positions.row(r).setConstant(pa(r));
+    out.positions.row(r) +=
+        Ra(r, 0) * b.positions.row(0) + Ra(r, 1) * b.positions.row(1) + Ra(r, 2) * b.positions.row(2);
+  }
+}
+
 } // namespace kinematicsTools
 } // namespace mc_state_observation
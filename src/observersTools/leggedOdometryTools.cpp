@@ -2,202 +2,85 @@
 
 #include <mc_state_observation/observersTools/leggedOdometryTools.h>
 
+#include <algorithm>
+#include <iterator>
+
 namespace so = stateObservation;
 
 namespace mc_state_observation
 {
+
+namespace measurements
+{
+template struct MapContacts<leggedOdometry::LoContactWithSensor, leggedOdometry::LoContactWithoutSensor>;
+template struct ContactsManager<leggedOdometry::LoContactWithSensor, leggedOdometry::LoContactWithoutSensor>;
+} // namespace measurements
+
 namespace leggedOdometry
 {
 
 ///////////////////////////////////////////////////////////////////////
-/// -------------------------Legged Odometry---------------------------
+/// ----------------------Legged Odometry Core-------------------------
 ///////////////////////////////////////////////////////////////////////
 
-void LeggedOdometryManager::init(const mc_control::MCController & ctl,
-                                 const std::string & robotName,
-                                 const std::string & odometryName,
-                                 OdometryType & odometryType,
-                                 const bool withYawEstimation,
-                                 const bool velUpdatedUpstream,
-                                 const bool accUpdatedUpstream,
-                                 const bool verbose,
-                                 const bool withModeSwitchInGui)
+void LeggedOdometryCore::init(const mc_rbdyn::Robot & robot,
+                              const std::string & odometryName,
+                              const OdometryType & odometryType,
+                              const bool withYawEstimation,
+                              const bool velUpdatedUpstream,
+                              const bool accUpdatedUpstream,
+                              const bool verbose)
 {
-  robotName_ = robotName;
   odometryType_ = odometryType;
   withYawEstimation_ = withYawEstimation;
   odometryName_ = odometryName;
   velUpdatedUpstream_ = velUpdatedUpstream;
   accUpdatedUpstream_ = accUpdatedUpstream;
-  const auto & robot = ctl.robot(robotName);
   odometryRobot_ = mc_rbdyn::Robots::make();
   odometryRobot_->robotCopy(robot, "odometryRobot");
 
   fbPose_.translation() = robot.posW().translation();
   fbPose_.rotation() = robot.posW().rotation();
   contactsManager_.init(odometryName, verbose);
-
-  if(!ctl.datastore().has("KinematicAnchorFrame::" + ctl.robot(robotName).name()))
-  {
-    double leftFootRatio = robot.indirectSurfaceForceSensor("LeftFootCenter").force().z()
-                           / (robot.indirectSurfaceForceSensor("LeftFootCenter").force().z()
-                              + robot.indirectSurfaceForceSensor("RightFootCenter").force().z());
-
-    worldAnchorPose_ = kinematicsTools::poseFromSva(
-        sva::interpolate(robot.surfacePose("RightFootCenter"), robot.surfacePose("LeftFootCenter"), leftFootRatio),
-        so::kine::Kinematics::Flags::pose);
-  }
-  else
-  {
-    worldAnchorPose_ =
-        kinematicsTools::poseFromSva(ctl.datastore().call<sva::PTransformd>(
-                                         "KinematicAnchorFrame::" + ctl.robot(robotName).name(), ctl.robot(robotName)),
-                                     so::kine::Kinematics::Flags::pose);
-  }
-
-  auto & logger = (const_cast<mc_control::MCController &>(ctl)).logger();
-  logger.addLogEntry(odometryName_ + "_odometryRobot_posW",
-                     [this]() -> sva::PTransformd { return odometryRobot().posW(); });
-
-  logger.addLogEntry(odometryName_ + "_odometryRobot_velW",
-                     [this]() -> sva::MotionVecd { return odometryRobot().velW(); });
-
-  logger.addLogEntry(odometryName_ + "_odometryRobot_accW",
-                     [this]() -> sva::MotionVecd { return odometryRobot().accW(); });
-  if(withModeSwitchInGui)
-  {
-    ctl.gui()->addElement({odometryName_, "Odometry"},
-                          mc_rtc::gui::ComboInput(
-                              "Choose from list", {"6dOdometry", "flatOdometry"},
-                              [this]() -> std::string
-                              {
-                                if(odometryType_ == measurements::flatOdometry) { return "flatOdometry"; }
-                                else { return "6dOdometry"; }
-                              },
-                              [this](const std::string & typeOfOdometry) { changeOdometryType(typeOfOdometry); }));
-    logger.addLogEntry(odometryName_ + "_debug_OdometryType",
-                       [this]() -> std::string
-                       {
-                         switch(odometryType_)
-                         {
-                           case measurements::flatOdometry:
-                             return "flatOdometry";
-                             break;
-                           case measurements::odometry6d:
-                             return "6dOdometry";
-                             break;
-                           default:
-                             break;
-                         }
-                         return "default";
-                       });
-  }
 }
 
-void LeggedOdometryManager::initDetection(const mc_control::MCController & ctl,
-                                          const std::string & robotName,
-                                          const ContactsManager::ContactsDetection & contactsDetection,
-                                          const std::vector<std::string> & surfacesForContactDetection,
-                                          const std::vector<std::string> & contactsSensorDisabledInit,
-                                          const double & contactsDetectionThreshold)
-{
-  contactsManager_.initDetection(ctl, robotName, contactsDetection, surfacesForContactDetection,
-                                 contactsSensorDisabledInit, contactsDetectionThreshold);
-}
-
-void LeggedOdometryManager::initDetection(const mc_control::MCController & ctl,
-                                          const std::string & robotName,
-                                          const ContactsManager::ContactsDetection & contactsDetection,
-                                          const std::vector<std::string> & contactsSensorDisabledInit,
-                                          const double & contactsDetectionThreshold,
-                                          const std::vector<std::string> & forceSensorsToOmit)
-{
-  contactsManager_.initDetection(ctl, robotName, contactsDetection, contactsSensorDisabledInit,
-                                 contactsDetectionThreshold, forceSensorsToOmit);
-}
-
-void LeggedOdometryManager::updateJointsConfiguration(const mc_control::MCController & ctl)
-{
-  const auto & realRobot = ctl.realRobot(robotName_);
-
-  std::vector<double> q0 = odometryRobot().mbc().q[0];
-  odometryRobot().mbc().q = realRobot.mbc().q;
-  odometryRobot().mbc().q[0] = q0;
-
-  odometryRobot().forwardKinematics();
-}
-
-void LeggedOdometryManager::run(const mc_control::MCController & ctl,
-                                mc_rtc::Logger & logger,
-                                sva::PTransformd & pose,
-                                sva::MotionVecd & vel,
-                                sva::MotionVecd & acc)
-{
-  const auto & realRobot = ctl.realRobot(robotName_);
-
-  const so::Matrix3 & realRobotOri = realRobot.posW().rotation().transpose();
-
-  run(ctl, logger, pose, vel, acc, realRobotOri);
-}
-
-void LeggedOdometryManager::run(const mc_control::MCController & ctl,
-                                mc_rtc::Logger & logger,
-                                sva::PTransformd & pose,
-                                sva::MotionVecd & vel)
+void LeggedOdometryCore::initDetection(const mc_rbdyn::Robot & robot,
+                                       const ContactsManager::ContactsDetection & contactsDetection,
+                                       const std::vector<std::string> & surfacesForContactDetection,
+                                       const std::vector<std::string> & contactsSensorDisabledInit,
+                                       const double & contactsDetectionThreshold)
 {
-  const auto & realRobot = ctl.realRobot(robotName_);
-
-  const so::Matrix3 & realRobotOri = realRobot.posW().rotation().transpose();
-
-  run(ctl, logger, pose, vel, realRobotOri);
+  contactsManager_.initDetection(robot, contactsDetection, surfacesForContactDetection, contactsSensorDisabledInit,
+                                 contactsDetectionThreshold);
 }
 
-void LeggedOdometryManager::run(const mc_control::MCController & ctl, mc_rtc::Logger & logger, sva::PTransformd & pose)
+void LeggedOdometryCore::initDetection(const mc_rbdyn::Robot & robot,
+                                       const ContactsManager::ContactsDetection & contactsDetection,
+                                       const std::vector<std::string> & contactsSensorDisabledInit,
+                                       const double & contactsDetectionThreshold,
+                                       const std::vector<std::string> & forceSensorsToOmit)
 {
-  const auto & realRobot = ctl.realRobot(robotName_);
-
-  const so::Matrix3 & realRobotOri = realRobot.posW().rotation().transpose();
-  // the tilt must come from another estimator so we use the real robot for the orientation
-  run(ctl, logger, pose, realRobotOri);
+  contactsManager_.initDetection(robot, contactsDetection, contactsSensorDisabledInit, contactsDetectionThreshold,
+                                 forceSensorsToOmit);
 }
 
-void LeggedOdometryManager::run(const mc_control::MCController & ctl,
-                                mc_rtc::Logger & logger,
-                                sva::PTransformd & pose,
-                                sva::MotionVecd & vel,
-                                sva::MotionVecd & acc,
-                                const stateObservation::Matrix3 & tilt)
+void LeggedOdometryCore::run(const mc_rbdyn::Robot & robot,
+                             const mc_rbdyn::Robot & realRobot,
+                             double dt,
+                             const stateObservation::Matrix3 & tilt,
+                             const bool updateVels,
+                             const bool updateAccs)
 {
-  updateJointsConfiguration(ctl);
-  odometryRobot().posW(fbPose_);
-
-  // we set the velocity and acceleration to zero as they will be compensated anyway as we compute the
-  // successive poses in the local frame
-  sva::MotionVecd zeroMotion;
-  zeroMotion.linear() = so::Vector3::Zero();
-  zeroMotion.angular() = so::Vector3::Zero();
-  odometryRobot().velW(zeroMotion);
-  odometryRobot().accW(zeroMotion);
-
-  odometryRobot().forwardKinematics();
-  odometryRobot().forwardVelocity();
-  odometryRobot().forwardAcceleration();
-
+  beginIteration(realRobot);
   // detects the contacts currently set with the environment
-  contactsManager().findContacts(ctl, robotName_);
+  contactsManager_.findContacts(robot);
   // updates the contacts and the resulting floating base kinematics
-  updateFbAndContacts(ctl, logger, true, true, tilt);
-  // updates the floating base kinematics in the observer
-  updateFbKinematics(pose, vel, acc);
+  updateFbAndContacts(robot, realRobot, dt, updateVels, updateAccs, tilt);
 }
 
-void LeggedOdometryManager::run(const mc_control::MCController & ctl,
-                                mc_rtc::Logger & logger,
-                                sva::PTransformd & pose,
-                                sva::MotionVecd & vel,
-                                const stateObservation::Matrix3 & tilt)
+void LeggedOdometryCore::beginIteration(const mc_rbdyn::Robot & realRobot)
 {
-  updateJointsConfiguration(ctl);
+  updateJointsConfiguration(realRobot);
   odometryRobot().posW(fbPose_);
 
   // we set the velocity and acceleration to zero as they will be compensated anyway as we compute the
@@ -211,50 +94,30 @@ void LeggedOdometryManager::run(const mc_control::MCController & ctl,
   odometryRobot().forwardKinematics();
   odometryRobot().forwardVelocity();
   odometryRobot().forwardAcceleration();
-
-  // detects the contacts currently set with the environment
-  contactsManager().findContacts(ctl, robotName_);
-  // updates the contacts and the resulting floating base kinematics
-  updateFbAndContacts(ctl, logger, true, false, tilt);
-  // updates the floating base kinematics in the observer
-  updateFbKinematics(pose, vel);
 }
 
-void LeggedOdometryManager::run(const mc_control::MCController & ctl,
-                                mc_rtc::Logger & logger,
-                                sva::PTransformd & pose,
-                                const stateObservation::Matrix3 & tilt)
+void LeggedOdometryCore::updateJointsConfiguration(const mc_rbdyn::Robot & realRobot)
 {
-  updateJointsConfiguration(ctl);
-  odometryRobot().posW(fbPose_);
-
-  // we set the velocity and acceleration to zero as they will be compensated anyway as we compute the
-  // successive poses in the local frame
-  sva::MotionVecd zeroMotion;
-  zeroMotion.linear() = so::Vector3::Zero();
-  zeroMotion.angular() = so::Vector3::Zero();
-  odometryRobot().velW(zeroMotion);
-  odometryRobot().accW(zeroMotion);
+  // the configuration of the floating base is kept. The joints are copied one by one, which reuses their buffers.
+  auto & q = odometryRobot().mbc().q;
+  std::copy(std::next(realRobot.mbc().q.begin()), realRobot.mbc().q.end(), std::next(q.begin()));
 
   odometryRobot().forwardKinematics();
-  odometryRobot().forwardVelocity();
-  odometryRobot().forwardAcceleration();
-
-  // detects the contacts currently set with the environment
-  contactsManager().findContacts(ctl, robotName_);
-  // updates the contacts and the resulting floating base kinematics
-  updateFbAndContacts(ctl, logger, false, false, tilt);
-  // updates the floating base kinematics in the observer
-  updateFbKinematics(pose);
 }
 
-void LeggedOdometryManager::getFbFromContacts(const mc_control::MCController & ctl,
-                                              bool & posUpdatable,
-                                              bool & oriUpdatable,
-                                              double & sumForces_position,
-                                              double & sumForces_orientation)
+void LeggedOdometryCore::getFbFromContacts(const mc_rbdyn::Robot & robot,
+                                           bool & posUpdatable,
+                                           bool & oriUpdatable,
+                                           double & sumForces_position,
+                                           double & sumForces_orientation)
 {
-  const auto & robot = ctl.robot(robotName_);
+  // the current pose of the floating base does not depend on the contacts
+  const so::kine::Kinematics worldFbPose_curr =
+      kinematicsTools::poseFromSva(odometryRobot().posW(), so::kine::Kinematics::Flags::pose);
+  const so::Matrix3 & worldFbOri_curr = worldFbPose_curr.orientation.toMatrix3();
+
+  // force weighted sum of the estimated floating base positions
+  so::Vector3 totalFbPosition = so::Vector3::Zero();
 
   // checks that the position and orientation can be updated from the currently set contacts and computes the pose of
   // the floating base obtained from each contact
@@ -262,53 +125,55 @@ void LeggedOdometryManager::getFbFromContacts(const mc_control::MCController & c
   {
     LoContactWithSensor & setContact = contactsManager_.contactWithSensor(setContactIndex);
 
-    const so::kine::Kinematics & worldFbPose_curr =
-        kinematicsTools::poseFromSva(odometryRobot().posW(), so::kine::Kinematics::Flags::pose);
+    // only the contacts that already exist are used to estimate the pose of the floating base
+    if(!setContact.wasAlreadySet_) { continue; }
 
-    // the contact already exists so we will use it to estimate the pose of the floating base
-    if(setContact.wasAlreadySet_)
-    {
-      // We can compute the position of the floating base using the contacts
-      posUpdatable = true;
+    // We can compute the position of the floating base using the contacts
+    posUpdatable = true;
 
-      sumForces_position += setContact.forceNorm_;
+    // the sum of the weights uses the force before the update of the contact kinematics, the weighted positions use
+    // the force after it
+    sumForces_position += setContact.forceNorm_;
 
-      // new kinematics of the contact obtained from the floating base. Used to obtain the updated position of the
-      // floating base wrt to the contact, in the world frame.
-      const so::kine::Kinematics & worldContactKine =
-          getCurrentContactKinematics(setContact, robot.forceSensor(setContact.getName()));
+    // new kinematics of the contact obtained from the floating base. Used to obtain the updated position of the
+    // floating base wrt to the contact, in the world frame.
+    const so::kine::Kinematics & worldContactKine =
+        getCurrentContactKinematics(setContact, robot.forceSensor(setContact.forceSensorName()));
 
-      setContact.currentWorldFbPose_.position =
-          setContact.worldRefKine_.position() + (worldFbPose_curr.position() - worldContactKine.position());
+    setContact.currentWorldFbPose_.position =
+        setContact.worldRefKine_.position() + (worldFbPose_curr.position() - worldContactKine.position());
+    totalFbPosition += setContact.currentWorldFbPose_.position() * setContact.forceNorm_;
 
-      if(withYawEstimation_ && setContact.useForOrientation_)
-      {
-        // the orientation can be computed using contacts
-        oriUpdatable = true;
+    if(withYawEstimation_ && setContact.useForOrientation_)
+    {
+      // the orientation can be computed using contacts
+      oriUpdatable = true;
 
-        sumForces_orientation += setContact.forceNorm_;
+      sumForces_orientation += setContact.forceNorm_;
 
-        so::Matrix3 contactFrameOri_odometryRobot =
-            worldContactKine.orientation.toMatrix3().transpose() * worldFbPose_curr.orientation.toMatrix3();
-        setContact.currentWorldFbPose_.orientation =
-            so::Matrix3(setContact.worldRefKine_.orientation.toMatrix3() * contactFrameOri_odometryRobot);
-      }
+      so::Matrix3 contactFrameOri_odometryRobot =
+          worldContactKine.orientation.toMatrix3().transpose() * worldFbOri_curr;
+      setContact.currentWorldFbPose_.orientation =
+          so::Matrix3(setContact.worldRefKine_.orientation.toMatrix3() * contactFrameOri_odometryRobot);
     }
   }
+
+  // the position of the floating base in the world is obtained by a weighted average of the estimations for each
+  // contact
+  if(posUpdatable) { fbPose_.translation() = totalFbPosition / sumForces_position; }
 }
 
-void LeggedOdometryManager::updateFbAndContacts(const mc_control::MCController & ctl,
-                                                mc_rtc::Logger & logger,
-                                                const bool updateVels,
-                                                const bool updateAccs,
-                                                const stateObservation::Matrix3 & tilt)
+void LeggedOdometryCore::updateFbAndContacts(const mc_rbdyn::Robot & robot,
+                                             const mc_rbdyn::Robot & realRobot,
+                                             double dt,
+                                             const bool updateVels,
+                                             const bool updateAccs,
+                                             const stateObservation::Matrix3 & tilt)
 {
   // If the position and orientation of the floating base can be updated using contacts (that were already set on the
   // previous iteration), they are updated, else we keep the previous estimation. Then we estimate the pose of new
   // contacts using the obtained pose of the floating base.
 
-  const auto & robot = ctl.robot(robotName_);
-
   double sumForces_position = 0.0;
   double sumForces_orientation = 0.0;
 
@@ -317,31 +182,13 @@ void LeggedOdometryManager::updateFbAndContacts(const mc_control::MCController &
   // indicates if the orientation can be updated from the current contacts or not
   bool oriUpdatable = false;
 
-  // force weighted sum of the estimated floating base positions
-  so::Vector3 totalFbPosition = so::Vector3::Zero();
-
   // selects the contacts to use for the yaw odometry
   selectForOrientationOdometry();
 
-  // checks that the position and orientation of the floating base can be updated from the currently set contacts and
-  // computes them for each contact
-  getFbFromContacts(ctl, posUpdatable, oriUpdatable, sumForces_position, sumForces_orientation);
+  // checks that the position and orientation of the floating base can be updated from the currently set contacts,
+  // computes them for each contact and fuses the estimated positions
+  getFbFromContacts(robot, posUpdatable, oriUpdatable, sumForces_position, sumForces_orientation);
 
-  // the position of the floating base in the world can be obtained by a weighted average of the estimations for each
-  // contact
-  if(posUpdatable)
-  {
-    for(const int & setContactIndex : contactsManager().contactsFound())
-    {
-      LoContactWithSensor & setContact = contactsManager_.contactWithSensor(setContactIndex);
-      if(setContact.wasAlreadySet_)
-      {
-        // force weighted sum of the estimated floating base positions
-        totalFbPosition += setContact.currentWorldFbPose_.position() * setContact.forceNorm_;
-        fbPose_.translation() = totalFbPosition / sumForces_position;
-      }
-    }
-  }
   if(oriUpdatable)
   {
     // the orientation can be updated using contacts, it will use at most the two most suitable contacts.
@@ -388,36 +235,22 @@ void LeggedOdometryManager::updateFbAndContacts(const mc_control::MCController &
   }
 
   // update of the pose of the floating base of the odometry robot in the world frame before creating the new contacts
-  updateOdometryRobot(ctl, updateVels, updateAccs);
+  updateOdometryRobot(realRobot, dt, updateVels, updateAccs);
 
   // computation of the reference kinematics of the newly set contacts in the world.
   for(const int & foundContactIndex : contactsManager().contactsFound())
   {
-
-    if(!contactsManager().contactWithSensor(foundContactIndex).wasAlreadySet_) // the contact was not set so we will
-                                                                               // compute its kinematics
-    {
-      LoContactWithSensor & foundContact = contactsManager_.contactWithSensor(foundContactIndex);
-
-      setNewContact(foundContact, robot);
-      addContactLogEntries(logger, foundContact);
-    }
-  }
-
-  for(auto & removedContactIndex : contactsManager().removedContacts())
-  {
-    LoContactWithSensor & removedContact = contactsManager_.contactWithSensor(removedContactIndex);
-
-    removeContactLogEntries(logger, removedContact);
+    LoContactWithSensor & foundContact = contactsManager_.contactWithSensor(foundContactIndex);
+    // the contact was not set so we will compute its kinematics
+    if(!foundContact.wasAlreadySet_) { setNewContact(foundContact, robot); }
   }
 }
 
-void LeggedOdometryManager::updateOdometryRobot(const mc_control::MCController & ctl,
-                                                const bool updateVels,
-                                                const bool updateAccs)
+void LeggedOdometryCore::updateOdometryRobot(const mc_rbdyn::Robot & realRobot,
+                                             double dt,
+                                             const bool updateVels,
+                                             const bool updateAccs)
 {
-  const auto & realRobot = ctl.realRobot(robotName_);
-
   // new estimated orientation of the floating base.
   so::kine::Orientation newOri(so::Matrix3(fbPose_.rotation().transpose()));
 
@@ -455,10 +288,20 @@ void LeggedOdometryManager::updateOdometryRobot(const mc_control::MCController &
     else
     {
       sva::MotionVecd vel;
+      sva::MotionVecd localVel;
 
-      vel.linear() = (fbPose_.translation() - odometryRobot().posW().translation()) / ctl.timeStep;
-      so::kine::Orientation oldOri(so::Matrix3(odometryRobot().posW().rotation().transpose()));
-      vel.angular() = oldOri.differentiate(newOri) / ctl.timeStep;
+      if(getFbVelocityFromContacts(realRobot, localVel))
+      {
+        vel.linear() = newOri * localVel.linear();
+        vel.angular() = newOri * localVel.angular();
+      }
+      else
+      {
+        // no contact can give the velocity, we use finite differences
+        vel.linear() = (fbPose_.translation() - odometryRobot().posW().translation()) / dt;
+        so::kine::Orientation oldOri(so::Matrix3(odometryRobot().posW().rotation().transpose()));
+        vel.angular() = oldOri.differentiate(newOri) / dt;
+      }
       odometryRobot().velW(vel);
     }
   }
@@ -472,7 +315,73 @@ void LeggedOdometryManager::updateOdometryRobot(const mc_control::MCController &
   if(updateAccs) { odometryRobot().forwardAcceleration(); }
 }
 
-void LeggedOdometryManager::updateFbKinematics(sva::PTransformd & pose, sva::MotionVecd & vel, sva::MotionVecd & acc)
+bool LeggedOdometryCore::getFbVelocityFromContacts(const mc_rbdyn::Robot & realRobot, sva::MotionVecd & localVel)
+{
+  const mc_rbdyn::Robot & odomRobot = odometryRobot();
+  const std::vector<std::vector<double>> & alpha = realRobot.mbc().alpha;
+  // the odometry robot is still in the configuration of the beginning of the iteration
+  const sva::PTransformd & worldFbPose = odomRobot.mbc().bodyPosW[0];
+  const so::Matrix3 & fbOriT = worldFbPose.rotation(); // transpose of the orientation of the floating base
+
+  // normal equations of the weighted least-squares problem on the velocity of the floating base (local frame)
+  Eigen::Matrix<double, 6, 6> normalMatrix = Eigen::Matrix<double, 6, 6>::Zero();
+  Eigen::Matrix<double, 6, 1> normalVector = Eigen::Matrix<double, 6, 1>::Zero();
+  Eigen::Matrix<double, 6, 6> A = Eigen::Matrix<double, 6, 6>::Identity();
+  Eigen::Matrix<double, 6, 1> b;
+
+  double sumForces = 0.0;
+
+  for(const int & setContactIndex : contactsManager().contactsFound())
+  {
+    const LoContactWithSensor & setContact = contactsManager_.contactWithSensor(setContactIndex);
+    // the contacts that were just created have no current kinematics yet
+    if(!setContact.wasAlreadySet_) { continue; }
+
+    const std::string & bodyName =
+        (contactsManager_.getContactsDetection() == ContactsManager::ContactsDetection::fromThreshold)
+            ? odomRobot.forceSensor(setContact.forceSensorName()).parentBody()
+            : odomRobot.surface(setContact.surfaceName()).bodyName();
+    const unsigned int bodyIndex = odomRobot.bodyIndexByName(bodyName);
+
+    // velocity of the parent body due to the joint velocities of the real robot only, in the frame of the body. The
+    // joints from the body to the floating base are summed, the velocity of each joint being transported to the body.
+    const sva::PTransformd & worldBodyPose = odomRobot.mbc().bodyPosW[bodyIndex];
+    sva::MotionVecd bodyVelB = sva::MotionVecd::Zero();
+    for(int joint = static_cast<int>(bodyIndex); joint > 0; joint = odomRobot.mb().parent(joint))
+    {
+      const sva::PTransformd jointBodyPose = worldBodyPose * odomRobot.mbc().bodyPosW[joint].inv();
+      bodyVelB += jointBodyPose * odomRobot.mb().joint(joint).motion(alpha[joint]);
+    }
+
+    // expressed in the world frame
+    const so::Matrix3 & bodyOriT = worldBodyPose.rotation();
+    const so::Vector3 worldBodyAngVel = bodyOriT.transpose() * bodyVelB.angular();
+    const so::Vector3 worldContactLinVel =
+        bodyOriT.transpose() * bodyVelB.linear()
+        + worldBodyAngVel.cross(setContact.currentWorldKine_.position() - worldBodyPose.translation());
+
+    // lever arm of the contact and joint contribution to its velocity, in the frame of the floating base
+    const so::Vector3 fbContactPos = fbOriT * (setContact.currentWorldKine_.position() - worldFbPose.translation());
+
+    // the velocity of the contact is v_fb + w_fb x r + v_joints = 0 and its angular velocity is w_fb + w_joints = 0
+    A.topRightCorner<3, 3>() = -so::kine::skewSymmetric(fbContactPos);
+    b << -(fbOriT * worldContactLinVel), -(fbOriT * worldBodyAngVel);
+
+    normalMatrix.noalias() += setContact.forceNorm_ * A.transpose() * A;
+    normalVector.noalias() += setContact.forceNorm_ * A.transpose() * b;
+    sumForces += setContact.forceNorm_;
+  }
+
+  if(sumForces <= 0.0) { return false; }
+
+  const Eigen::Matrix<double, 6, 1> fbVel = normalMatrix.ldlt().solve(normalVector);
+  localVel.linear() = fbVel.head<3>();
+  localVel.angular() = fbVel.tail<3>();
+
+  return true;
+}
+
+void LeggedOdometryCore::updateFbKinematics(sva::PTransformd & pose, sva::MotionVecd & vel, sva::MotionVecd & acc)
 {
   pose.rotation() = odometryRobot().posW().rotation();
   pose.translation() = odometryRobot().posW().translation();
@@ -486,7 +395,7 @@ void LeggedOdometryManager::updateFbKinematics(sva::PTransformd & pose, sva::Mot
   acc.angular() = odometryRobot().accW().angular();
 }
 
-void LeggedOdometryManager::updateFbKinematics(sva::PTransformd & pose, sva::MotionVecd & vel)
+void LeggedOdometryCore::updateFbKinematics(sva::PTransformd & pose, sva::MotionVecd & vel)
 {
   pose.rotation() = odometryRobot().posW().rotation();
   pose.translation() = odometryRobot().posW().translation();
@@ -497,13 +406,13 @@ void LeggedOdometryManager::updateFbKinematics(sva::PTransformd & pose, sva::Mot
   vel.angular() = odometryRobot().velW().angular();
 }
 
-void LeggedOdometryManager::updateFbKinematics(sva::PTransformd & pose)
+void LeggedOdometryCore::updateFbKinematics(sva::PTransformd & pose)
 {
   pose.rotation() = odometryRobot().posW().rotation();
   pose.translation() = odometryRobot().posW().translation();
 }
 
-void LeggedOdometryManager::setNewContact(LoContactWithSensor & contact, const mc_rbdyn::Robot & measurementsRobot)
+void LeggedOdometryCore::setNewContact(LoContactWithSensor & contact, const mc_rbdyn::Robot & measurementsRobot)
 {
   const mc_rbdyn::ForceSensor & forceSensor = measurementsRobot.forceSensor(contact.forceSensorName());
   // If the contact is not detected using surfaces, we must consider that the frame of the sensor is the one of the
@@ -548,9 +457,10 @@ void LeggedOdometryManager::setNewContact(LoContactWithSensor & contact, const m
   if(odometryType_ == measurements::flatOdometry) { contact.worldRefKine_.position()(2) = 0.0; }
 }
 
-const so::kine::Kinematics & LeggedOdometryManager::getCurrentContactKinematics(LoContactWithSensor & contact,
-                                                                                const mc_rbdyn::ForceSensor & fs)
+const so::kine::Kinematics & LeggedOdometryCore::getCurrentContactKinematics(LoContactWithSensor & contact,
+                                                                             const mc_rbdyn::ForceSensor & fs)
 {
+  const mc_rbdyn::Robot & odomRobot = odometryRobot();
   // robot is necessary because odometry robot doesn't have the copy of the force measurements
   const sva::PTransformd & bodyContactSensorPose = fs.X_p_f();
   so::kine::Kinematics bodyContactSensorKine =
@@ -558,7 +468,7 @@ const so::kine::Kinematics & LeggedOdometryManager::getCurrentContactKinematics(
 
   // kinematics of the sensor's parent body in the world
   so::kine::Kinematics worldBodyKineOdometryRobot =
-      kinematicsTools::poseFromSva(odometryRobot().mbc().bodyPosW[odometryRobot().bodyIndexByName(fs.parentBody())],
+      kinematicsTools::poseFromSva(odomRobot.mbc().bodyPosW[odomRobot.bodyIndexByName(fs.parentBody())],
                                    so::kine::Kinematics::Flags::pose);
 
   so::kine::Kinematics worldSensorKineOdometryRobot = worldBodyKineOdometryRobot * bodyContactSensorKine;
@@ -572,19 +482,19 @@ const so::kine::Kinematics & LeggedOdometryManager::getCurrentContactKinematics(
   else // the kinematics of the contact are the ones of the associated surface
   {
     // the kinematics of the contacts are the ones of the surface, but we must transport the measured wrench
-    sva::PTransformd worldSurfacePoseOdometryRobot = odometryRobot().surfacePose(contact.surfaceName());
+    sva::PTransformd worldSurfacePoseOdometryRobot = odomRobot.surfacePose(contact.surfaceName());
     contact.currentWorldKine_ =
         kinematicsTools::poseFromSva(worldSurfacePoseOdometryRobot, so::kine::Kinematics::Flags::pose);
 
     so::kine::Kinematics contactSensorKine = contact.currentWorldKine_.getInverse() * worldSensorKineOdometryRobot;
     // expressing the force measurement in the frame of the surface
-    contact.forceNorm_ = (contactSensorKine.orientation * fs.wrenchWithoutGravity(odometryRobot()).force()).norm();
+    contact.forceNorm_ = (contactSensorKine.orientation * fs.wrenchWithoutGravity(odomRobot).force()).norm();
   }
 
   return contact.currentWorldKine_;
 }
 
-void LeggedOdometryManager::selectForOrientationOdometry()
+void LeggedOdometryCore::selectForOrientationOdometry()
 {
   contactsManager_.oriOdometryContacts_.clear();
   for(auto it = contactsManager_.contactsFound().begin(); it != contactsManager_.contactsFound().end(); it++)
@@ -592,43 +502,21 @@ void LeggedOdometryManager::selectForOrientationOdometry()
     LoContactWithSensor & contact = contactsManager_.contactWithSensor(*it);
     if(contact.getName().find("Hand") == std::string::npos
        && contact.wasAlreadySet_) // we don't use hands for the orientation odometry
-    {
-      contact.useForOrientation_ = true;
-      contactsManager_.oriOdometryContacts_.insert(contact);
-    }
-  }
-  // contacts are sorted from the lowest force to the highest force
-  while(contactsManager_.oriOdometryContacts_.size() > 2)
-  {
-    (*contactsManager_.oriOdometryContacts_.begin()).get().useForOrientation_ = false;
-    contactsManager_.oriOdometryContacts_.erase(contactsManager_.oriOdometryContacts_.begin());
-  }
-}
-
-void LeggedOdometryManager::addContactLogEntries(mc_rtc::Logger & logger, const LoContactWithSensor & contact)
-{
-  const std::string & contactName = contact.getName();
-  kinematicsTools::addToLogger(contact.worldRefKine_, logger, odometryName_ + "_" + contactName + "_refPose");
-  kinematicsTools::addToLogger(contact.currentWorldFbPose_, logger,
-                               odometryName_ + "_" + contactName + "_currentWorldFbPose");
-  kinematicsTools::addToLogger(contact.currentWorldKine_, logger,
-                               odometryName_ + "_" + contactName + "_currentWorldContactKine");
-}
-
-void LeggedOdometryManager::removeContactLogEntries(mc_rtc::Logger & logger, const LoContactWithSensor & contact)
-{
-  const std::string & contactName = contact.getName();
-  logger.removeLogEntry(odometryName_ + "_" + contactName + "_ref_position");
-  logger.removeLogEntry(odometryName_ + "_" + contactName + "_ref_orientation");
-  kinematicsTools::removeFromLogger(logger, odometryName_ + "_" + contactName + "_refPose");
-  kinematicsTools::removeFromLogger(logger, odometryName_ + "_" + contactName + "_currentWorldFbPose");
-  kinematicsTools::removeFromLogger(logger, odometryName_ + "_" + contactName + "_currentWorldContactKine");
+    {
+      contact.useForOrientation_ = true;
+      contactsManager_.oriOdometryContacts_.insert(contact);
+    }
+  }
+  // contacts are sorted from the lowest force to the highest force
+  while(contactsManager_.oriOdometryContacts_.size() > 2)
+  {
+    (*contactsManager_.oriOdometryContacts_.begin()).get().useForOrientation_ = false;
+    contactsManager_.oriOdometryContacts_.erase(contactsManager_.oriOdometryContacts_.begin());
+  }
 }
 
-so::kine::Kinematics & LeggedOdometryManager::getAnchorFramePose(const mc_control::MCController & ctl)
+so::kine::Kinematics & LeggedOdometryCore::getAnchorFramePose(const mc_rbdyn::Robot & robot)
 {
-  const auto & robot = ctl.robot(robotName_);
-
   double sumForces_position = 0.0;
   double sumForces_orientation = 0.0;
 
@@ -711,11 +599,9 @@ so::kine::Kinematics & LeggedOdometryManager::getAnchorFramePose(const mc_contro
   return worldAnchorPose_;
 }
 
-so::kine::Kinematics & LeggedOdometryManager::getAnchorFramePose(const mc_control::MCController & ctl,
-                                                                 const std::string & bodySensorName)
+so::kine::Kinematics & LeggedOdometryCore::getAnchorFramePose(const mc_rbdyn::Robot & robot,
+                                                              const std::string & bodySensorName)
 {
-  const auto & robot = ctl.robot(robotName_);
-
   double sumForces_position = 0.0;
   double sumForces_orientation = 0.0;
 
@@ -769,7 +655,7 @@ so::kine::Kinematics & LeggedOdometryManager::getAnchorFramePose(const mc_contro
   {
     // if we cannot update the position (so not the orientations either) using contacts, we use the IMU frame as the
     // anchor frame.
-    const auto & imu = ctl.robot(robotName_).bodySensor(bodySensorName);
+    const auto & imu = robot.bodySensor(bodySensorName);
 
     const sva::PTransformd & imuXbs = imu.X_b_s();
     so::kine::Kinematics parentImuKine = kinematicsTools::poseFromSva(imuXbs, so::kine::Kinematics::Flags::pose);
@@ -824,7 +710,7 @@ so::kine::Kinematics & LeggedOdometryManager::getAnchorFramePose(const mc_contro
   }
   else
   {
-    const auto & imu = ctl.robot(robotName_).bodySensor(bodySensorName);
+    const auto & imu = robot.bodySensor(bodySensorName);
     const sva::PTransformd & imuXbs = imu.X_b_s();
     so::kine::Kinematics parentImuKine = kinematicsTools::poseFromSva(imuXbs, so::kine::Kinematics::Flags::pose);
 
@@ -840,7 +726,7 @@ so::kine::Kinematics & LeggedOdometryManager::getAnchorFramePose(const mc_contro
   return worldAnchorPose_;
 }
 
-void LeggedOdometryManager::changeOdometryType(const std::string & newOdometryType)
+void LeggedOdometryCore::changeOdometryType(const std::string & newOdometryType)
 {
   OdometryType prevOdometryType = odometryType_;
   if(newOdometryType == "flatOdometry") { odometryType_ = measurements::flatOdometry; }
@@ -852,9 +738,277 @@ void LeggedOdometryManager::changeOdometryType(const std::string & newOdometryTy
   }
 }
 
-void LeggedOdometryManager::changeOdometryType(const OdometryType & newOdometryType)
+void LeggedOdometryCore::changeOdometryType(const OdometryType & newOdometryType)
 {
   odometryType_ = newOdometryType;
 }
+
+///////////////////////////////////////////////////////////////////////
+/// -------------------------Legged Odometry---------------------------
+///////////////////////////////////////////////////////////////////////
+
+void LeggedOdometryManager::init(const mc_control::MCController & ctl,
+                                 const std::string & robotName,
+                                 const std::string & odometryName,
+                                 OdometryType & odometryType,
+                                 const bool withYawEstimation,
+                                 const bool velUpdatedUpstream,
+                                 const bool accUpdatedUpstream,
+                                 const bool verbose,
+                                 const bool withModeSwitchInGui)
+{
+  robotName_ = robotName;
+  const auto & robot = ctl.robot(robotName);
+  LeggedOdometryCore::init(robot, odometryName, odometryType, withYawEstimation, velUpdatedUpstream,
+                           accUpdatedUpstream, verbose);
+
+  if(!ctl.datastore().has("KinematicAnchorFrame::" + ctl.robot(robotName).name()))
+  {
+    double leftFootRatio = robot.indirectSurfaceForceSensor("LeftFootCenter").force().z()
+                           / (robot.indirectSurfaceForceSensor("LeftFootCenter").force().z()
+                              + robot.indirectSurfaceForceSensor("RightFootCenter").force().z());
+
+    worldAnchorPose_ = kinematicsTools::poseFromSva(
+        sva::interpolate(robot.surfacePose("RightFootCenter"), robot.surfacePose("LeftFootCenter"), leftFootRatio),
+        so::kine::Kinematics::Flags::pose);
+  }
+  else
+  {
+    worldAnchorPose_ =
+        kinematicsTools::poseFromSva(ctl.datastore().call<sva::PTransformd>(
+                                         "KinematicAnchorFrame::" + ctl.robot(robotName).name(), ctl.robot(robotName)),
+                                     so::kine::Kinematics::Flags::pose);
+  }
+
+  auto & logger = (const_cast<mc_control::MCController &>(ctl)).logger();
+  logger.addLogEntry(odometryName_ + "_odometryRobot_posW",
+                     [this]() -> sva::PTransformd { return odometryRobot().posW(); });
+
+  logger.addLogEntry(odometryName_ + "_odometryRobot_velW",
+                     [this]() -> sva::MotionVecd { return odometryRobot().velW(); });
+
+  logger.addLogEntry(odometryName_ + "_odometryRobot_accW",
+                     [this]() -> sva::MotionVecd { return odometryRobot().accW(); });
+  if(withModeSwitchInGui)
+  {
+    ctl.gui()->addElement({odometryName_, "Odometry"},
+                          mc_rtc::gui::ComboInput(
+                              "Choose from list", {"6dOdometry", "flatOdometry"},
+                              [this]() -> std::string
+                              {
+                                if(odometryType_ == measurements::flatOdometry) { return "flatOdometry"; }
+                                else { return "6dOdometry"; }
+                              },
+                              [this](const std::string & typeOfOdometry) { changeOdometryType(typeOfOdometry); }));
+    logger.addLogEntry(odometryName_ + "_debug_OdometryType",
+                       [this]() -> std::string
+                       {
+                         switch(odometryType_)
+                         {
+                           case measurements::flatOdometry:
+                             return "flatOdometry";
+                             break;
+                           case measurements::odometry6d:
+                             return "6dOdometry";
+                             break;
+                           default:
+                             break;
+                         }
+                         return "default";
+                       });
+  }
+}
+
+void LeggedOdometryManager::initDetection(const mc_control::MCController & ctl,
+                                          const std::string & robotName,
+                                          const ContactsManager::ContactsDetection & contactsDetection,
+                                          const std::vector<std::string> & surfacesForContactDetection,
+                                          const std::vector<std::string> & contactsSensorDisabledInit,
+                                          const double & contactsDetectionThreshold)
+{
+  contactsManager_.initDetection(ctl, robotName, contactsDetection, surfacesForContactDetection,
+                                 contactsSensorDisabledInit, contactsDetectionThreshold);
+}
+
+void LeggedOdometryManager::initDetection(const mc_control::MCController & ctl,
+                                          const std::string & robotName,
+                                          const ContactsManager::ContactsDetection & contactsDetection,
+                                          const std::vector<std::string> & contactsSensorDisabledInit,
+                                          const double & contactsDetectionThreshold,
+                                          const std::vector<std::string> & forceSensorsToOmit)
+{
+  contactsManager_.initDetection(ctl, robotName, contactsDetection, contactsSensorDisabledInit,
+                                 contactsDetectionThreshold, forceSensorsToOmit);
+}
+
+void LeggedOdometryManager::updateJointsConfiguration(const mc_control::MCController & ctl)
+{
+  LeggedOdometryCore::updateJointsConfiguration(inputRealRobot(ctl.realRobot(robotName_)));
+}
+
+void LeggedOdometryManager::run(const mc_control::MCController & ctl,
+                                mc_rtc::Logger & logger,
+                                sva::PTransformd & pose,
+                                sva::MotionVecd & vel,
+                                sva::MotionVecd & acc)
+{
+  const auto & realRobot = inputRealRobot(ctl.realRobot(robotName_));
+
+  const so::Matrix3 & realRobotOri = realRobot.posW().rotation().transpose();
+
+  run(ctl, logger, pose, vel, acc, realRobotOri);
+}
+
+void LeggedOdometryManager::run(const mc_control::MCController & ctl,
+                                mc_rtc::Logger & logger,
+                                sva::PTransformd & pose,
+                                sva::MotionVecd & vel)
+{
+  const auto & realRobot = inputRealRobot(ctl.realRobot(robotName_));
+
+  const so::Matrix3 & realRobotOri = realRobot.posW().rotation().transpose();
+
+  run(ctl, logger, pose, vel, realRobotOri);
+}
+
+void LeggedOdometryManager::run(const mc_control::MCController & ctl, mc_rtc::Logger & logger, sva::PTransformd & pose)
+{
+  const auto & realRobot = inputRealRobot(ctl.realRobot(robotName_));
+
+  const so::Matrix3 & realRobotOri = realRobot.posW().rotation().transpose();
+  // the tilt must come from another estimator so we use the real robot for the orientation
+  run(ctl, logger, pose, realRobotOri);
+}
+
+void LeggedOdometryManager::run(const mc_control::MCController & ctl,
+                                mc_rtc::Logger & logger,
+                                sva::PTransformd & pose,
+                                sva::MotionVecd & vel,
+                                sva::MotionVecd & acc,
+                                const stateObservation::Matrix3 & tilt)
+{
+  beginIteration(inputRealRobot(ctl.realRobot(robotName_)));
+
+  // detects the contacts currently set with the environment
+  findContacts(ctl);
+  // updates the contacts and the resulting floating base kinematics
+  updateFbAndContacts(ctl, logger, true, true, tilt);
+  // updates the floating base kinematics in the observer
+  updateFbKinematics(pose, vel, acc);
+}
+
+void LeggedOdometryManager::run(const mc_control::MCController & ctl,
+                                mc_rtc::Logger & logger,
+                                sva::PTransformd & pose,
+                                sva::MotionVecd & vel,
+                                const stateObservation::Matrix3 & tilt)
+{
+  beginIteration(inputRealRobot(ctl.realRobot(robotName_)));
+
+  // detects the contacts currently set with the environment
+  findContacts(ctl);
+  // updates the contacts and the resulting floating base kinematics
+  updateFbAndContacts(ctl, logger, true, false, tilt);
+  // updates the floating base kinematics in the observer
+  updateFbKinematics(pose, vel);
+}
+
+void LeggedOdometryManager::run(const mc_control::MCController & ctl,
+                                mc_rtc::Logger & logger,
+                                sva::PTransformd & pose,
+                                const stateObservation::Matrix3 & tilt)
+{
+  beginIteration(inputRealRobot(ctl.realRobot(robotName_)));
+
+  // detects the contacts currently set with the environment
+  findContacts(ctl);
+  // updates the contacts and the resulting floating base kinematics
+  updateFbAndContacts(ctl, logger, false, false, tilt);
+  // updates the floating base kinematics in the observer
+  updateFbKinematics(pose);
+}
+
+void LeggedOdometryManager::updateFbAndContacts(const mc_control::MCController & ctl,
+                                                mc_rtc::Logger & logger,
+                                                const bool updateVels,
+                                                const bool updateAccs,
+                                                const stateObservation::Matrix3 & tilt)
+{
+  LeggedOdometryCore::updateFbAndContacts(inputRobot(ctl.robot(robotName_)), inputRealRobot(ctl.realRobot(robotName_)),
+                                          ctl.timeStep, updateVels, updateAccs, tilt);
+
+  for(const int & foundContactIndex : contactsManager().contactsFound())
+  {
+    const LoContactWithSensor & foundContact = contactsManager_.contactWithSensor(foundContactIndex);
+    if(!foundContact.wasAlreadySet_) { addContactLogEntries(logger, foundContact); }
+  }
+
+  for(auto & removedContactIndex : contactsManager().removedContacts())
+  {
+    LoContactWithSensor & removedContact = contactsManager_.contactWithSensor(removedContactIndex);
+
+    removeContactLogEntries(logger, removedContact);
+  }
+}
+
+void LeggedOdometryManager::findContacts(const mc_control::MCController & ctl)
+{
+  // the contacts given by the solver are not part of the measurements
+  if(inputRobot_ != nullptr
+     && contactsManager_.getContactsDetection() != ContactsManager::ContactsDetection::fromSolver)
+  {
+    contactsManager_.findContacts(*inputRobot_);
+  }
+  else { contactsManager_.findContacts(ctl, robotName_); }
+}
+
+void LeggedOdometryManager::getFbFromContacts(const mc_control::MCController & ctl,
+                                              bool & posUpdatable,
+                                              bool & oriUpdatable,
+                                              double & sumForces_position,
+                                              double & sumForces_orientation)
+{
+  LeggedOdometryCore::getFbFromContacts(inputRobot(ctl.robot(robotName_)), posUpdatable, oriUpdatable,
+                                        sumForces_position, sumForces_orientation);
+}
+
+void LeggedOdometryManager::updateOdometryRobot(const mc_control::MCController & ctl,
+                                                const bool updateVels,
+                                                const bool updateAccs)
+{
+  LeggedOdometryCore::updateOdometryRobot(inputRealRobot(ctl.realRobot(robotName_)), ctl.timeStep, updateVels,
+                                          updateAccs);
+}
+
+so::kine::Kinematics & LeggedOdometryManager::getAnchorFramePose(const mc_control::MCController & ctl)
+{
+  return LeggedOdometryCore::getAnchorFramePose(inputRobot(ctl.robot(robotName_)));
+}
+
+so::kine::Kinematics & LeggedOdometryManager::getAnchorFramePose(const mc_control::MCController & ctl,
+                                                                 const std::string & bodySensorName)
+{
+  return LeggedOdometryCore::getAnchorFramePose(inputRobot(ctl.robot(robotName_)), bodySensorName);
+}
+
+void LeggedOdometryManager::addContactLogEntries(mc_rtc::Logger & logger, const LoContactWithSensor & contact)
+{
+  const std::string & contactName = contact.getName();
+  kinematicsTools::addToLogger(contact.worldRefKine_, logger, odometryName_ + "_" + contactName + "_refPose");
+  kinematicsTools::addToLogger(contact.currentWorldFbPose_, logger,
+                               odometryName_ + "_" + contactName + "_currentWorldFbPose");
+  kinematicsTools::addToLogger(contact.currentWorldKine_, logger,
+                               odometryName_ + "_" + contactName + "_currentWorldContactKine");
+}
+
+void LeggedOdometryManager::removeContactLogEntries(mc_rtc::Logger & logger, const LoContactWithSensor & contact)
+{
+  const std::string & contactName = contact.getName();
+  logger.removeLogEntry(odometryName_ + "_" + contactName + "_ref_position");
+  logger.removeLogEntry(odometryName_ + "_" + contactName + "_ref_orientation");
+  kinematicsTools::removeFromLogger(logger, odometryName_ + "_" + contactName + "_refPose");
+  kinematicsTools::removeFromLogger(logger, odometryName_ + "_" + contactName + "_currentWorldFbPose");
+  kinematicsTools::removeFromLogger(logger, odometryName_ + "_" + contactName + "_currentWorldContactKine");
+}
 } // namespace leggedOdometry
 } // namespace mc_state_observation
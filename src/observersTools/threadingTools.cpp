@@ -0,0 +1,151 @@
+#include <mc_rtc/logging.h>
+#include <mc_state_observation/observersTools/threadingTools.h>
+
+#include <fmt/ranges.h>
+
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+
+namespace mc_state_observation
+{
+namespace threadingTools
+{
+
+bool setThreadAffinity(std::thread & thread, const std::vector<int> & cpus)
+{
+  if(cpus.empty()) { return true; }
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  for(const int & cpu : cpus) { CPU_SET(cpu, &cpuset); }
+  return pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cpuset) == 0;
+}
+
+bool setThreadScheduling(std::thread & thread, const std::string & policy, int priority)
+{
+  int schedPolicy;
+  if(policy == "other") { schedPolicy = SCHED_OTHER; }
+  else if(policy == "batch") { schedPolicy = SCHED_BATCH; }
+  else if(policy == "idle") { schedPolicy = SCHED_IDLE; }
+  else if(policy == "fifo") { schedPolicy = SCHED_FIFO; }
+  else if(policy == "rr") { schedPolicy = SCHED_RR; }
+  else { return false; }
+
+  sched_param param;
+  std::memset(&param, 0, sizeof(param));
+  // the static priority must be 0 for the non real-time policies
+  if(schedPolicy == SCHED_FIFO || schedPolicy == SCHED_RR) { param.sched_priority = priority; }
+  return pthread_setschedparam(thread.native_handle(), schedPolicy, &param) == 0;
+}
+
+bool configureThread(std::thread & thread, const mc_rtc::Configuration & config, const std::string & observerName)
+{
+  bool success = true;
+
+  const std::vector<int> cpus = config("cpus", std::vector<int>{});
+  if(!setThreadAffinity(thread, cpus))
+  {
+    mc_rtc::log::warning("[{}] Could not pin the thread to the cpus [{}]", observerName, fmt::join(cpus, ", "));
+    success = false;
+  }
+
+  if(config.has("policy"))
+  {
+    const std::string policy = config("policy");
+    const int priority = config("priority", 1);
+    if(!setThreadScheduling(thread, policy, priority))
+    {
+      mc_rtc::log::warning("[{}] Could not set the scheduling policy {} with the priority {} (the policy must be among "
+                           "[other, batch, idle, fifo, rr] and the real-time policies require privileges)",
+                           observerName, policy, priority);
+      success = false;
+    }
+  }
+  return success;
+}
+
+///////////////////////////////////////////////////////////////////////
+/// ----------------------------Worker pool----------------------------
+///////////////////////////////////////////////////////////////////////
+
+WorkerPool::WorkerPool(size_t nbThreads, const std::vector<int> & cpus)
+{
+  threads_.reserve(nbThreads);
+  for(size_t i = 0; i < nbThreads; i++)
+  {
+    threads_.emplace_back([this]() { workerLoop(); });
+    if(!cpus.empty()) { setThreadAffinity(threads_.back(), {cpus[i % cpus.size()]}); }
+  }
+}
+
+WorkerPool::~WorkerPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  startCondition_.notify_all();
+  for(auto & thread : threads_) { thread.join(); }
+}
+
+void WorkerPool::parallelFor(size_t nbTasks, const std::function<void(size_t)> & task)
+{
+  if(nbTasks == 0) { return; }
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    // workers that woke up late for the previous batch must be done before the counters are reset
+    doneCondition_.wait(lock, [this]() { return activeWorkers_ == 0; });
+    task_ = &task;
+    nbTasks_ = nbTasks;
+    nextTask_ = 0;
+    remainingTasks_ = nbTasks;
+    ++generation_;
+  }
+  startCondition_.notify_all();
+
+  work();
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  doneCondition_.wait(lock, [this]() { return remainingTasks_ == 0; });
+}
+
+void WorkerPool::workerLoop()
+{
+  size_t seenGeneration = 0;
+  while(true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      startCondition_.wait(lock, [this, &seenGeneration]() { return stop_ || generation_ != seenGeneration; });
+      if(stop_) { return; }
+      seenGeneration = generation_;
+      ++activeWorkers_;
+    }
+
+    work();
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      --activeWorkers_;
+    }
+    doneCondition_.notify_all();
+  }
+}
+
+void WorkerPool::work()
+{
+  size_t i;
+  while((i = nextTask_.fetch_add(1)) < nbTasks_)
+  {
+    (*task_)(i);
+    if(remainingTasks_.fetch_sub(1) == 1)
+    {
+      // locking ensures the notification cannot be missed by the thread waiting in parallelFor
+      std::lock_guard<std::mutex> lock(mutex_);
+      doneCondition_.notify_all();
+    }
+  }
+}
+
+} // namespace threadingTools
+} // namespace mc_state_observation
@@ -0,0 +1,163 @@
+#include <mc_rtc/gui/Table.h>
+#include <mc_rtc/logging.h>
+#include <mc_state_observation/observersTools/timingTools.h>
+
+#include <algorithm>
+
+namespace mc_state_observation
+{
+namespace timingTools
+{
+
+size_t ExecutionTimer::addStage(const std::string & name)
+{
+  Stage stage;
+  stage.name = name;
+  stage.samples.resize(windowSize_, 0.0);
+  stages_.push_back(std::move(stage));
+  sortedSamples_.reserve(windowSize_);
+  return stages_.size() - 1;
+}
+
+ExecutionTimer::Statistics ExecutionTimer::statistics(size_t stage) const
+{
+  const Stage & s = stages_[stage];
+  Statistics stats;
+  stats.last = s.last;
+  if(s.count == 0) { return stats; }
+
+  sortedSamples_.assign(s.samples.begin(), s.samples.begin() + static_cast<long>(s.count));
+  const auto minMax = std::minmax_element(sortedSamples_.begin(), sortedSamples_.end());
+  stats.min = *minMax.first;
+  stats.max = *minMax.second;
+  double sum = 0.0;
+  for(const double & sample : sortedSamples_) { sum += sample; }
+  stats.mean = sum / static_cast<double>(s.count);
+
+  const auto p99 = sortedSamples_.begin() + static_cast<long>((s.count - 1) * 99 / 100);
+  std::nth_element(sortedSamples_.begin(), p99, sortedSamples_.end());
+  stats.p99 = *p99;
+
+  return stats;
+}
+
+void ExecutionTimer::reset()
+{
+  for(auto & stage : stages_)
+  {
+    stage.next = 0;
+    stage.count = 0;
+    stage.last = 0.0;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////
+/// --------------------------Logging and GUI--------------------------
+///////////////////////////////////////////////////////////////////////
+
+void ExecutionTimer::addToLogger(mc_rtc::Logger & logger, const std::string & prefix)
+{
+  if(!enabled_) { return; }
+  for(size_t i = 0; i < stages_.size(); i++)
+  {
+    logger.addLogEntry(prefix + "_timings_" + stages_[i].name, [this, i]() -> double { return stages_[i].last; });
+  }
+}
+
+void ExecutionTimer::removeFromLogger(mc_rtc::Logger & logger, const std::string & prefix)
+{
+  for(const auto & stage : stages_) { logger.removeLogEntry(prefix + "_timings_" + stage.name); }
+}
+
+void ExecutionTimer::addToGUI(mc_rtc::gui::StateBuilder & gui, const std::vector<std::string> & category)
+{
+  if(!enabled_) { return; }
+  gui.addElement(category,
+                 mc_rtc::gui::Table("Timings [ms]", {"Stage", "last", "min", "mean", "p99", "max"},
+                                    [this]()
+                                    {
+                                      std::vector<std::vector<std::string>> rows;
+                                      rows.reserve(stages_.size());
+                                      for(size_t i = 0; i < stages_.size(); i++)
+                                      {
+                                        const Statistics stats = statistics(i);
+                                        rows.push_back({stages_[i].name, fmt::format("{:.4f}", stats.last),
+                                                        fmt::format("{:.4f}", stats.min),
+                                                        fmt::format("{:.4f}", stats.mean),
+                                                        fmt::format("{:.4f}", stats.p99),
+                                                        fmt::format("{:.4f}", stats.max)});
+                                      }
+                                      return rows;
+                                    }),
+                 mc_rtc::gui::Button("Reset timings", [this]() { reset(); }));
+}
+
+void ExecutionTimer::removeFromGUI(mc_rtc::gui::StateBuilder & gui, const std::vector<std::string> & category)
+{
+  gui.removeElement(category, "Timings [ms]");
+  gui.removeElement(category, "Reset timings");
+}
+
+///////////////////////////////////////////////////////////////////////
+/// --------------------------Deadline monitor-------------------------
+///////////////////////////////////////////////////////////////////////
+
+void DeadlineMonitor::configure(const mc_rtc::Configuration & config, const std::string & observerName)
+{
+  observerName_ = observerName;
+  budget_ = config("budget", 0.0);
+  overrunIterations_ = std::max(config("overrunIterations", 3u), 1u);
+  recoveryIterations_ = std::max(config("recoveryIterations", 500u), 1u);
+  reset();
+}
+
+void DeadlineMonitor::stop()
+{
+  if(!enabled()) { return; }
+  last_ = std::chrono::duration<double, std::milli>(Clock::now() - start_).count();
+
+  // counts the consecutive iterations which would make the mode change
+  if((last_ > budget_) != degraded_) { ++count_; }
+  else { count_ = 0; }
+
+  if(!degraded_ && count_ >= overrunIterations_)
+  {
+    degraded_ = true;
+    count_ = 0;
+    ++nbDegradations_;
+    mc_rtc::log::warning("[{}] Iteration took {:.3f} ms for a budget of {:.3f} ms, switching to the degraded mode",
+                         observerName_, last_, budget_);
+  }
+  else if(degraded_ && count_ >= recoveryIterations_)
+  {
+    degraded_ = false;
+    count_ = 0;
+    mc_rtc::log::info("[{}] Back within the budget of {:.3f} ms for {} iterations, switching to the nominal mode",
+                      observerName_, budget_, recoveryIterations_);
+  }
+}
+
+void DeadlineMonitor::reset()
+{
+  degraded_ = false;
+  count_ = 0;
+  last_ = 0.0;
+}
+
+void DeadlineMonitor::addToLogger(mc_rtc::Logger & logger, const std::string & prefix)
+{
+  if(!enabled()) { return; }
+  logger.addLogEntry(prefix + "_deadline_duration", [this]() -> double { return last_; });
+  logger.addLogEntry(prefix + "_deadline_degraded", [this]() -> bool { return degraded_; });
+  logger.addLogEntry(prefix + "_deadline_nbDegradations", [this]() -> double { return nbDegradations_; });
+}
+
+void DeadlineMonitor::removeFromLogger(mc_rtc::Logger & logger, const std::string & prefix)
+{
+  logger.removeLogEntry(prefix + "_deadline_duration");
+  logger.removeLogEntry(prefix + "_deadline_degraded");
+  logger.removeLogEntry(prefix + "_deadline_nbDegradations");
+}
+
+} // namespace timingTools
+} // namespace mc_state_observation